@@ -0,0 +1,134 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#include "ItchFeedHandler.h"
+
+/*Feed handler throughput. Writes an ITCH capture of adds, executions,
+  partial cancels, deletes and replaces spread over 256 symbols, each
+  quoted within a dollar either side of its own price in penny ticks and
+  never crossed. Nine in ten executions and cancels hit one of the 4096
+  newest orders, as on a real feed. The capture is then mapped and every
+  book built from it on one thread, printing messages per second. Takes
+  the message count (20M by default) and the capture path on the command
+  line*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr std::uint16_t SymbolCount{ 256 };
+
+struct LiveOrder
+{
+    std::uint64_t orderRef_{ };
+    std::uint16_t locate_{ };
+    Side side_{ };
+    std::uint32_t shares_{ };
+};
+
+void WriteCapture(const std::filesystem::path& path, std::size_t messages)
+{
+    std::mt19937_64 random{ 17 };
+    ItchCaptureWriter capture;
+    std::vector<LiveOrder> live;
+    std::vector<std::uint32_t> basePrices;
+    std::uint64_t nextOrderRef{ 1 }, matchNumber{ 1 };
+
+    for (std::uint16_t locate = 1; locate <= SymbolCount; ++locate)
+    {
+        capture.StockDirectory(locate, "SYM" + std::to_string(locate));
+        basePrices.push_back(static_cast<std::uint32_t>(10 + random() % 190) * 10'000);
+    }
+
+    auto Price = [&](std::uint16_t locate, Side side)
+    {
+        const auto offset = static_cast<std::uint32_t>(1 + random() % 100) * 100;
+        return side == Side::Buy ? basePrices[locate - 1] - offset : basePrices[locate - 1] + offset;
+    };
+
+    for (std::size_t message = 0; message < messages; ++message)
+    {
+        const auto kind = random() % 100;
+        if (kind < 40 || live.size() < 1000)
+        {
+            const auto locate = static_cast<std::uint16_t>(1 + random() % SymbolCount);
+            const auto side = random() % 2 ? Side::Buy : Side::Sell;
+            const auto shares = static_cast<std::uint32_t>(1 + random() % 10) * 100;
+            const auto orderRef = nextOrderRef++;
+            if (kind % 10)
+                capture.AddOrder(locate, orderRef, side, shares, Price(locate, side));
+            else
+                capture.AddAttributedOrder(locate, orderRef, side, shares, Price(locate, side), "MPID");
+            live.push_back(LiveOrder{ orderRef, locate, side, shares });
+            continue;
+        }
+
+        //Most orders are cancelled or hit soon after they are added
+        const auto recent = std::min<std::size_t>(live.size(), 4096);
+        const auto index = random() % 10 ? live.size() - 1 - random() % recent : random() % live.size();
+        auto& order = live[index];
+        if (kind < 50)
+        {
+            const auto shares = std::min<std::uint32_t>(order.shares_, 100);
+            capture.Execute(order.locate_, order.orderRef_, shares, matchNumber++);
+            order.shares_ -= shares;
+        }
+        else if (kind < 60 && order.shares_ > 100)
+        {
+            capture.Cancel(order.locate_, order.orderRef_, 100);
+            order.shares_ -= 100;
+        }
+        else if (kind < 95)
+        {
+            capture.Delete(order.locate_, order.orderRef_);
+            order.shares_ = 0;
+        }
+        else
+        {
+            const auto newOrderRef = nextOrderRef++;
+            capture.Replace(order.locate_, order.orderRef_, newOrderRef, order.shares_, Price(order.locate_, order.side_));
+            order.orderRef_ = newOrderRef;
+        }
+
+        if (!order.shares_)
+        {
+            order = live.back();
+            live.pop_back();
+        }
+    }
+
+    std::ofstream file{ path, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(capture.Bytes().data()), static_cast<std::streamsize>(capture.Bytes().size()));
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t messages = argc > 1 ? std::stoul(argv[1]) : 20'000'000;
+    const std::filesystem::path path = argc > 2 ? argv[2]
+        : std::filesystem::temp_directory_path() / "orderbook_itch_benchmark.bin";
+
+    WriteCapture(path, messages);
+    std::cout << messages << " messages, " << std::filesystem::file_size(path) / 1'000'000 << " MB" << std::endl;
+
+    //Many small books, prices in cents so the default band covers every level
+    OrderbookConfig config;
+    config.expectedOrders_ = 1 << 12;
+
+    ItchFeedHandler handler{ config };
+    const auto start = SteadyClock::now();
+    const auto consumed = handler.ProcessFile(path);
+    const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+
+    const auto& stats = handler.Stats();
+    std::cout << "feed handler: " << static_cast<std::uint64_t>(stats.messages_ / seconds) << " messages/s, "
+              << seconds * 1e9 / stats.messages_ << " ns/message, " << consumed / seconds / 1e6 << " MB/s" << std::endl;
+    std::cout << stats.adds_ << " adds, " << stats.executions_ << " executions, " << stats.cancels_ << " cancels, "
+              << stats.deletes_ << " deletes, " << stats.replaces_ << " replaces, " << stats.skipped_ << " skipped, "
+              << stats.unknownOrders_ << " unknown orders, "
+              << handler.LiveOrders() << " orders live" << std::endl;
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "CommandJournal.h"
+#include "Orderbook.h"
+#include "SnapshotWriter.h"
+
+/*Cost of journalling and speed of restarting. Applies a mixed flow of adds,
+  cancels, modifies and crossing orders to a book without a journal and
+  then to one with, waits for the last record to be synced and snapshots
+  the book. A fresh book is then recovered from the whole journal, and
+  another from the snapshot plus the journal tail after it. Takes the
+  command count (50M by default) and the journal path on the command line;
+  the snapshot is written beside the journal*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+class Flow
+{
+    private:
+        std::mt19937_64 random_{ 5 };
+        OrderId nextOrderId_{ 1 };
+
+    public:
+        Command Next()
+        {
+            const auto orderId = nextOrderId_++;
+            const auto side = random_() % 2 ? Side::Buy : Side::Sell;
+            const auto quantity = static_cast<Quantity>(1 + random_() % 100);
+            const auto kind = random_() % 10;
+
+            //Mostly passive prices away from 1000, one in ten crosses
+            const auto offset = static_cast<std::int32_t>(kind ? 1 + random_() % 20 : 0);
+            const Price price{ side == Side::Buy ? 1000 - offset : 1000 + offset };
+
+            if (kind < 3 && orderId > 1)
+                return Command::Cancel(0, orderId - 1 - random_() % std::min<OrderId>(orderId - 1, 1000));
+            if (kind < 4 && orderId > 1)
+                return Command::Modify(0, OrderModify{ orderId - 1, side, price, quantity });
+            return Command::Add(0, Order{ OrderType::GoodTillCancel, orderId, side, price, quantity });
+        }
+};
+
+OrderbookConfig MakeConfig(CommandJournal* journal)
+{
+    OrderbookConfig config;
+    config.singleWriter_ = true;
+    config.sequentialOrderIds_ = true;
+    config.journal_ = journal;
+    return config;
+}
+
+double Apply(Orderbook& orderbook, std::size_t commands)
+{
+    Flow flow;
+    const auto start = SteadyClock::now();
+    for (std::size_t command = 0; command < commands; ++command)
+        orderbook.Apply(flow.Next(), TradeSink::Discard());
+    return std::chrono::duration<double>(SteadyClock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t commands = argc > 1 ? std::stoul(argv[1]) : 50'000'000;
+    const std::filesystem::path path = argc > 2 ? argv[2]
+        : std::filesystem::temp_directory_path() / "orderbook_journal_benchmark.bin";
+    auto snapshotPath = path;
+    snapshotPath += ".snapshot";
+    std::filesystem::remove(path);
+
+    {
+        Orderbook orderbook{ MakeConfig(nullptr) };
+        const auto seconds = Apply(orderbook, commands);
+        std::cout << "no journal:  " << static_cast<std::uint64_t>(commands / seconds) << " commands/s" << std::endl;
+    }
+
+    std::uint64_t lastSequence;
+    {
+        CommandJournal journal{ path };
+        Orderbook orderbook{ MakeConfig(&journal) };
+        const auto seconds = Apply(orderbook, commands);
+
+        const auto syncStart = SteadyClock::now();
+        lastSequence = orderbook.LastSequence();
+        journal.WaitDurable(lastSequence);
+        const auto syncSeconds = std::chrono::duration<double>(SteadyClock::now() - syncStart).count();
+
+        std::cout << "journal:     " << static_cast<std::uint64_t>(commands / seconds) << " commands/s, "
+                  << lastSequence << " records in " << journal.Batches() << " group commits, last synced "
+                  << syncSeconds * 1e3 << "ms after the matcher finished" << std::endl;
+
+        //Only the capture runs on the matcher, the writer thread does the I/O
+        SnapshotWriter writer;
+        const auto captureStart = SteadyClock::now();
+        auto image = orderbook.CaptureSnapshot();
+        const auto captureSeconds = std::chrono::duration<double>(SteadyClock::now() - captureStart).count();
+        const auto orders = image.orders_.size();
+
+        const auto writeStart = SteadyClock::now();
+        writer.Write(snapshotPath, std::move(image));
+        writer.Wait();
+        const auto writeSeconds = std::chrono::duration<double>(SteadyClock::now() - writeStart).count();
+
+        std::cout << "snapshot:    " << orders << " orders captured in " << captureSeconds * 1e3
+                  << "ms on the matcher, written in " << writeSeconds * 1e3 << "ms on the writer" << std::endl;
+    }
+
+    {
+        const auto start = SteadyClock::now();
+        CommandJournal journal{ path };
+        Orderbook orderbook{ MakeConfig(&journal) };
+        const auto recovered = journal.Recover(orderbook);
+        const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+
+        std::cout << "recovery:    " << recovered << " of " << lastSequence << " records in " << seconds
+                  << "s, " << static_cast<std::uint64_t>(recovered / seconds) << " records/s, "
+                  << orderbook.Size() << " orders resting" << std::endl;
+    }
+
+    {
+        const auto start = SteadyClock::now();
+        SnapshotReader snapshot{ snapshotPath };
+        CommandJournal journal{ path };
+        Orderbook orderbook{ MakeConfig(&journal) };
+        orderbook.Restore(snapshot.Orders(), snapshot.LastSequence());
+        const auto recovered = journal.Recover(orderbook);
+        const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+
+        std::cout << "restart:     snapshot at " << snapshot.LastSequence() << " plus journal tail to "
+                  << recovered << " in " << seconds << "s, " << orderbook.Size() << " orders resting" << std::endl;
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(snapshotPath);
+}
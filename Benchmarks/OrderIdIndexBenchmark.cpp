@@ -0,0 +1,103 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+
+#include "OrderIdIndex.h"
+
+/*Compares std::unordered_map against OrderIdIndex, in both modes, for the
+  orderbook's access pattern: lookups of live ids, and churn where the oldest
+  order leaves as a new one arrives, at a fixed count of live orders*/
+
+using Clock = std::chrono::steady_clock;
+
+struct Entry
+{
+    std::uint64_t handle_{ };
+};
+
+struct StdMap
+{
+    std::unordered_map<OrderId, Entry> map_;
+
+    explicit StdMap(std::size_t size) { map_.reserve(size); }
+    void Insert(OrderId orderId, Entry entry) { map_.emplace(orderId, entry); }
+    const Entry* Find(OrderId orderId) const
+    {
+        auto iterator = map_.find(orderId);
+        return iterator == map_.end() ? nullptr : &iterator->second;
+    }
+    void Erase(OrderId orderId) { map_.erase(orderId); }
+};
+
+template <OrderIdIndex<Entry>::Mode Mode>
+struct FlatIndex
+{
+    OrderIdIndex<Entry> index_;
+
+    explicit FlatIndex(std::size_t size) : index_{ Mode, size } { }
+    void Insert(OrderId orderId, Entry entry) { index_.Insert(orderId, entry); }
+    const Entry* Find(OrderId orderId) const { return index_.Find(orderId); }
+    void Erase(OrderId orderId) { index_.Erase(orderId); }
+};
+
+/*Ids are either sequential, as most venues assign them, or scattered 64-bit
+  values. The id of the i-th order is ids[i]*/
+template <typename Index>
+void Run(const char* name, const std::vector<OrderId>& ids, std::size_t liveOrders)
+{
+    const auto operations = ids.size() - liveOrders;
+
+    Index index{ liveOrders };
+    for (std::size_t order = 0; order < liveOrders; ++order)
+        index.Insert(ids[order], Entry{ order });
+
+    std::mt19937_64 random{ 42 };
+    std::vector<OrderId> probes(operations);
+    for (auto& probe : probes)
+        probe = ids[random() % liveOrders];
+
+    auto start = Clock::now();
+    std::uint64_t checksum{ };
+    for (auto orderId : probes)
+        checksum += index.Find(orderId)->handle_;
+    const auto lookup = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+
+    start = Clock::now();
+    for (std::size_t order = liveOrders; order < ids.size(); ++order)
+    {
+        index.Erase(ids[order - liveOrders]);
+        index.Insert(ids[order], Entry{ order });
+    }
+    const auto churn = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+
+    std::cout << "  " << name << " lookup=" << lookup << "ns churn=" << churn << "ns"
+              << " (checksum " << checksum % 10 << ")" << std::endl;
+}
+
+int main()
+{
+    constexpr std::size_t Operations{ 10'000'000 };
+
+    for (std::size_t liveOrders : { 1'000'000, 10'000'000 })
+    {
+        std::vector<OrderId> ids(liveOrders + Operations);
+        for (std::size_t order = 0; order < ids.size(); ++order)
+            ids[order] = order;
+
+        std::cout << "live=" << liveOrders << " sequential ids" << std::endl;
+        Run<StdMap>("std::unordered_map  ", ids, liveOrders);
+        Run<FlatIndex<OrderIdIndex<Entry>::Mode::Hashed>>("OrderIdIndex Hashed ", ids, liveOrders);
+        Run<FlatIndex<OrderIdIndex<Entry>::Mode::Dense>>("OrderIdIndex Dense  ", ids, liveOrders);
+
+        std::mt19937_64 random{ 1 };
+        for (auto& orderId : ids)
+            orderId = random() >> 1;
+
+        std::cout << "live=" << liveOrders << " random ids" << std::endl;
+        Run<StdMap>("std::unordered_map  ", ids, liveOrders);
+        Run<FlatIndex<OrderIdIndex<Entry>::Mode::Hashed>>("OrderIdIndex Hashed ", ids, liveOrders);
+    }
+    return 0;
+}
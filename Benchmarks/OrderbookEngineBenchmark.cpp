@@ -0,0 +1,127 @@
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "OrderbookEngine.h"
+
+/*Add-to-ack latency with several clients trading one book, either calling a
+  locked Orderbook directly, where the ack is the call returning, or through
+  OrderbookEngine, where it is the Done response arriving. Every client
+  alternates adding a resting order and cancelling it, so the book stays
+  small and every command is answered. The engine's busy polling needs a
+  core to itself and one per client to show its latency*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr std::size_t RoundsPerClient{ 200'000 };
+
+Order MakeOrder(std::size_t client, std::size_t round)
+{
+    //Bids below 1000 and asks above, so nothing ever crosses
+    const auto side = client % 2 ? Side::Sell : Side::Buy;
+    const Price price{ side == Side::Buy ? 990 - static_cast<std::int32_t>(round % 8)
+                                         : 1010 + static_cast<std::int32_t>(round % 8) };
+    return Order{ OrderType::GoodTillCancel, (client << 32) | round, side, price, 10 };
+}
+
+void Report(const char* name, std::vector<double>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    auto Percentile = [&latencies](double percentile)
+    {
+        return latencies[static_cast<std::size_t>(percentile * (latencies.size() - 1))];
+    };
+
+    std::cout << "  " << name << " p50=" << Percentile(0.50) << "ns p99=" << Percentile(0.99)
+              << "ns p99.9=" << Percentile(0.999) << "ns" << std::endl;
+}
+
+template <typename Client>
+std::vector<double> RunClients(std::size_t clientCount, Client client)
+{
+    std::vector<std::vector<double>> latencies(clientCount);
+    std::vector<std::thread> threads;
+    for (std::size_t index = 0; index < clientCount; ++index)
+        threads.emplace_back([&, index]
+        {
+            latencies[index].reserve(RoundsPerClient);
+            client(index, latencies[index]);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::vector<double> merged;
+    for (const auto& clientLatencies : latencies)
+        merged.insert(merged.end(), clientLatencies.begin(), clientLatencies.end());
+    return merged;
+}
+
+std::vector<double> RunLocked(std::size_t clientCount)
+{
+    Orderbook orderbook;
+    return RunClients(clientCount, [&orderbook](std::size_t client, std::vector<double>& latencies)
+    {
+        for (std::size_t round = 0; round < RoundsPerClient; ++round)
+        {
+            const auto order = MakeOrder(client, round);
+            const auto start = SteadyClock::now();
+            orderbook.AddOrder(order, TradeSink::Discard());
+            latencies.push_back(std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count());
+            orderbook.CancelOrder(order.GetOrderId());
+        }
+    });
+}
+
+//Busy-polls attempt, yielding now and then so an oversubscribed machine still makes progress
+template <typename Attempt>
+void Spin(Attempt attempt)
+{
+    for (std::size_t polls = 1; !attempt(); ++polls)
+        if (polls % 1024 == 0)
+            std::this_thread::yield();
+}
+
+std::vector<double> RunEngine(std::size_t clientCount)
+{
+    OrderbookEngine engine{ clientCount };
+    return RunClients(clientCount, [&engine](std::size_t client, std::vector<double>& latencies)
+    {
+        OrderbookEngine::Response response;
+        auto AwaitDone = [&]
+        {
+            Spin([&]{ return engine.TryPoll(client, response) && response.kind_ == OrderbookEngine::Response::Kind::Done; });
+        };
+
+        for (std::size_t round = 0; round < RoundsPerClient; ++round)
+        {
+            const auto order = MakeOrder(client, round);
+            const auto start = SteadyClock::now();
+            Spin([&]{ return engine.TrySubmit(client, Command::Add(0, order), round); });
+            AwaitDone();
+            latencies.push_back(std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count());
+
+            Spin([&]{ return engine.TrySubmit(client, Command::Cancel(0, order.GetOrderId()), round); });
+            AwaitDone();
+        }
+    });
+}
+
+//Pass a client count to override the default of two
+int main(int argc, char** argv)
+{
+    const std::size_t clientCount = argc > 1 ? std::stoul(argv[1]) : 2;
+    std::cout << "clients=" << clientCount << " adds per client=" << RoundsPerClient
+              << " cores=" << std::thread::hardware_concurrency() << std::endl;
+
+    auto locked = RunLocked(clientCount);
+    Report("locked Orderbook", locked);
+
+    auto engine = RunEngine(clientCount);
+    Report("OrderbookEngine ", engine);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "OrderbookManager.h"
+
+/*Measures OrderbookManager throughput as shards are added, with flow spread
+  evenly across many symbols. Each shard count gets as many submitting
+  threads, each driving its own slice of symbols, so both the submitters and
+  the matching threads scale together. Expect close to linear growth up to
+  the core count*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr SymbolId Symbols{ 1024 };
+constexpr std::size_t CommandsPerSymbol{ 2'000 };
+
+/*Limit orders within a few ticks of 1000 on both sides, so about half of them
+  cross, with a third of the flow cancelling an earlier order of the symbol*/
+std::vector<Command> MakeFlow(SymbolId firstSymbol, SymbolId lastSymbol, std::uint64_t seed)
+{
+    std::mt19937_64 random{ seed };
+    std::vector<Command> flow;
+    flow.reserve((lastSymbol - firstSymbol) * CommandsPerSymbol);
+
+    for (std::size_t step = 1; step <= CommandsPerSymbol; ++step)
+        for (SymbolId symbolId = firstSymbol; symbolId < lastSymbol; ++symbolId)
+        {
+            if (step > 1 && random() % 3 == 0)
+            {
+                flow.push_back(Command::Cancel(symbolId, 1 + random() % (step - 1)));
+                continue;
+            }
+
+            const auto side = random() % 2 ? Side::Buy : Side::Sell;
+            const Price price{ 1000 + static_cast<std::int32_t>(random() % 9) - 4 };
+            flow.push_back(Command::Add(symbolId, Order{ OrderType::GoodTillCancel, step, side,
+                price, static_cast<Quantity>(1 + random() % 100) }));
+        }
+
+    return flow;
+}
+
+double Run(std::size_t shardCount)
+{
+    OrderbookConfig bookConfig;
+    bookConfig.bandTicks_ = 256;
+
+    std::vector<std::vector<Command>> flows;
+    for (std::size_t producer = 0; producer < shardCount; ++producer)
+    {
+        //Symbols of one producer all belong to one shard, none are shared
+        std::vector<Command> flow;
+        for (SymbolId symbolId = static_cast<SymbolId>(producer); symbolId < Symbols;
+            symbolId += static_cast<SymbolId>(shardCount))
+        {
+            const auto symbolFlow = MakeFlow(symbolId, symbolId + 1, symbolId);
+            flow.insert(flow.end(), symbolFlow.begin(), symbolFlow.end());
+        }
+        flows.push_back(std::move(flow));
+    }
+
+    OrderbookManager manager{ shardCount, bookConfig };
+
+    const auto start = SteadyClock::now();
+    std::vector<std::thread> producers;
+    for (const auto& flow : flows)
+        producers.emplace_back([&manager, &flow]
+        {
+            for (const auto& command : flow)
+                manager.Submit(command);
+        });
+
+    for (auto& producer : producers)
+        producer.join();
+    manager.Flush();
+
+    const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+    return Symbols * CommandsPerSymbol / seconds;
+}
+
+//Pass a shard count to go past the number of cores
+int main(int argc, char** argv)
+{
+    const auto cores = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "symbols=" << Symbols << " commands=" << Symbols * CommandsPerSymbol
+              << " cores=" << cores << std::endl;
+
+    double baseline{ };
+    for (std::size_t shardCount = 1; shardCount <= cores; shardCount *= 2)
+    {
+        const auto throughput = Run(shardCount);
+        if (shardCount == 1)
+            baseline = throughput;
+
+        std::cout << "  shards=" << shardCount << " " << throughput / 1e6 << "M commands/s"
+                  << " (x" << throughput / baseline << ")" << std::endl;
+    }
+    return 0;
+}
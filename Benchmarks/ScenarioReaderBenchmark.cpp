@@ -0,0 +1,155 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#include "BinaryScenario.h"
+#include "Orderbook.h"
+#include "ScenarioReader.h"
+
+/*Scenario parsing throughput. Writes a scenario of mixed adds, modifies and
+  cancels, then reads it back: line by line with std::getline and a vector
+  of fields per line, as scenarios used to be read, and through a
+  ScenarioReader over the mapped file. The file is then converted to the
+  binary format and its mapped commands read in turn. Both readers finally
+  feed a single-writer book, which is a whole replay. Takes the line count
+  (20M by default) and the file path on the command line*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+void WriteScenario(const std::filesystem::path& path, std::size_t lines)
+{
+    std::mt19937_64 random{ 11 };
+    std::ofstream file{ path, std::ios::binary };
+    std::string line;
+
+    for (std::size_t orderId = 1; orderId <= lines; ++orderId)
+    {
+        const auto kind = random() % 10;
+        const char side = random() % 2 ? 'B' : 'S';
+        const auto price = side == 'B' ? 1000 - random() % 20 : 1001 + random() % 20;
+        const auto quantity = 1 + random() % 100;
+
+        if (kind < 2 && orderId > 1)
+            line = "C " + std::to_string(orderId - 1 - random() % std::min<std::size_t>(orderId - 1, 1000));
+        else if (kind < 3 && orderId > 1)
+            line = "M " + std::to_string(orderId - 1) + ' ' + side + ' ' + std::to_string(price) + ' ' + std::to_string(quantity);
+        else
+            line = std::string{ "A " } + side + " GoodTillCancel " + std::to_string(price) + ' '
+                + std::to_string(quantity) + ' ' + std::to_string(orderId);
+
+        file << line << '\n';
+    }
+}
+
+//Field splitting the way the parser did before ScenarioReader, for comparison
+std::size_t ReadWithGetline(const std::filesystem::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    std::string line;
+    std::size_t fields{ };
+
+    while (std::getline(file, line) && !line.empty())
+    {
+        std::vector<std::string_view> columns;
+        std::string_view rest{ line };
+        for (auto space = rest.find(' '); space != std::string_view::npos; space = rest.find(' '))
+        {
+            columns.push_back(rest.substr(0, space));
+            rest.remove_prefix(space + 1);
+        }
+        columns.push_back(rest);
+        fields += columns.size();
+    }
+    return fields;
+}
+
+void Report(const char* name, double seconds, std::size_t bytes, std::size_t lines)
+{
+    std::cout << name << static_cast<std::uint64_t>(bytes / seconds / 1e6) << " MB/s, "
+              << static_cast<std::uint64_t>(lines / seconds) << " lines/s, "
+              << seconds * 1e9 / lines << " ns/line" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t lines = argc > 1 ? std::stoul(argv[1]) : 20'000'000;
+    const std::filesystem::path path = argc > 2 ? argv[2]
+        : std::filesystem::temp_directory_path() / "orderbook_scenario_benchmark.txt";
+
+    WriteScenario(path, lines);
+    const auto bytes = std::filesystem::file_size(path);
+    std::cout << lines << " lines, " << bytes / 1'000'000 << " MB" << std::endl;
+
+    {
+        const auto start = SteadyClock::now();
+        const auto fields = ReadWithGetline(path);
+        Report("getline:         ", std::chrono::duration<double>(SteadyClock::now() - start).count(), bytes, lines);
+        if (!fields)
+            return 1;
+    }
+
+    {
+        const auto start = SteadyClock::now();
+        ScenarioReader reader{ path };
+        std::uint64_t checksum{ };
+        for (const auto& command : reader)
+            checksum += command.orderId_;
+        Report("ScenarioReader:  ", std::chrono::duration<double>(SteadyClock::now() - start).count(), bytes, lines);
+        if (!checksum)
+            return 1;
+    }
+
+    auto binaryPath = path;
+    binaryPath += ".bin";
+    auto binaryBytes = [&binaryPath]{ return std::filesystem::file_size(binaryPath); };
+    {
+        const auto start = SteadyClock::now();
+        ScenarioReader reader{ path };
+        WriteBinaryScenario(binaryPath, reader);
+        const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+        std::cout << "converted to " << binaryBytes() / 1'000'000
+                  << " MB of binary in " << seconds << "s" << std::endl;
+    }
+
+    {
+        const auto start = SteadyClock::now();
+        BinaryScenarioReader reader{ binaryPath };
+        std::uint64_t checksum{ };
+        for (const auto& command : reader.Commands())
+            checksum += command.orderId_;
+        Report("binary:          ", std::chrono::duration<double>(SteadyClock::now() - start).count(), binaryBytes(), lines);
+        if (!checksum)
+            return 1;
+    }
+
+    OrderbookConfig config;
+    config.singleWriter_ = true;
+    config.sequentialOrderIds_ = true;
+    config.expectedOrders_ = lines;
+
+    {
+        const auto start = SteadyClock::now();
+        ScenarioReader reader{ path };
+        Orderbook orderbook{ config };
+        for (const auto& command : reader)
+            orderbook.Apply(command, TradeSink::Discard());
+        Report("text + replay:   ", std::chrono::duration<double>(SteadyClock::now() - start).count(), bytes, lines);
+    }
+
+    {
+        const auto start = SteadyClock::now();
+        BinaryScenarioReader reader{ binaryPath };
+        Orderbook orderbook{ config };
+        for (const auto& command : reader.Commands())
+            orderbook.Apply(command, TradeSink::Discard());
+        Report("binary + replay: ", std::chrono::duration<double>(SteadyClock::now() - start).count(), binaryBytes(), lines);
+        std::cout << orderbook.Size() << " orders resting" << std::endl;
+    }
+
+    std::filesystem::remove(binaryPath);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,105 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <iostream>
+#include <algorithm>
+
+#include "SequencedOrderbook.h"
+
+/*Several producer threads adding and cancelling resting orders on one book
+  for a fixed time, either calling a locked Orderbook directly, where the
+  order is whoever wins the mutex, or through SequencedOrderbook. Prints the
+  total rate and each producer's share of it, so convoying on the mutex and
+  unfairness between producers both show. Producers need a core each and
+  the matcher one more*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds RunTime{ 1000 };
+
+Command MakeCommand(std::size_t producer, std::uint64_t round)
+{
+    //Each producer adds on odd rounds and cancels that order on the next, nothing crosses
+    const OrderId orderId = (static_cast<OrderId>(producer) << 32) | (round / 2);
+    if (round % 2)
+        return Command::Cancel(0, orderId);
+
+    const auto side = producer % 2 ? Side::Sell : Side::Buy;
+    const Price price{ side == Side::Buy ? 990 - static_cast<std::int32_t>(round % 16)
+                                         : 1010 + static_cast<std::int32_t>(round % 16) };
+    return Command::Add(0, Order{ OrderType::GoodTillCancel, orderId, side, price, 10 });
+}
+
+template <typename Submit>
+std::vector<std::uint64_t> RunProducers(std::size_t producerCount, Submit submit)
+{
+    std::vector<std::uint64_t> counts(producerCount);
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> threads;
+
+    for (std::size_t producer = 0; producer < producerCount; ++producer)
+        threads.emplace_back([&, producer]
+        {
+            std::uint64_t round{ };
+            while (!stop.load(std::memory_order_relaxed))
+                submit(producer, MakeCommand(producer, round++));
+            counts[producer] = round;
+        });
+
+    std::this_thread::sleep_for(RunTime);
+    stop.store(true);
+    for (auto& thread : threads)
+        thread.join();
+    return counts;
+}
+
+void Report(const char* name, const std::vector<std::uint64_t>& counts, SteadyClock::duration elapsed)
+{
+    std::uint64_t total{ };
+    for (const auto count : counts)
+        total += count;
+
+    const auto [fewest, most] = std::minmax_element(counts.begin(), counts.end());
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << "  " << name << ": " << static_cast<std::uint64_t>(total / seconds) << " commands/s, per producer "
+              << 100.0 * *fewest / total << "% to " << 100.0 * *most / total << "% of the stream" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t maxProducers = argc > 1 ? std::stoul(argv[1])
+        : std::max(2u, std::thread::hardware_concurrency() - 1);
+
+    for (std::size_t producers = 1; producers <= maxProducers; producers *= 2)
+    {
+        std::cout << producers << " producers" << std::endl;
+
+        {
+            Orderbook orderbook;
+            const auto start = SteadyClock::now();
+            const auto counts = RunProducers(producers, [&orderbook](std::size_t, const Command& command)
+            {
+                orderbook.Apply(command, TradeSink::Discard());
+            });
+            Report("locked", counts, SteadyClock::now() - start);
+        }
+
+        {
+            SequencedOrderbook orderbook{ producers };
+            const auto start = SteadyClock::now();
+            const auto counts = RunProducers(producers, [&orderbook](std::size_t producer, const Command& command)
+            {
+                orderbook.Submit(producer, command);
+            });
+            orderbook.Flush();
+            Report("sequenced", counts, SteadyClock::now() - start);
+
+            std::uint64_t stalls{ };
+            for (std::size_t producer = 0; producer < producers; ++producer)
+                stalls += orderbook.GetProducerStats(producer).stalls_;
+            std::cout << "    submits that waited for room: " << stalls << std::endl;
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "Orderbook.h"
+#include "OrderPool.h"
+#include "SnapshotFile.h"
+
+/*How long taking a snapshot holds the book's lock. Rests peak orders, as a
+  busy open would, then cancels all but live of them, leaving the survivors
+  spread over a pool sized for the peak. The book is captured into a fresh
+  image, then repeatedly into one reused image while a second thread adds
+  and cancels against the locked book and times each call, its worst wait
+  being the lock hold the matcher sees. For comparison it times copying a
+  pool of the peak size, which is what capturing cost when the whole pool
+  was copied. Takes the peak and live order counts (4M and 250k by default)
+  on the command line*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+double Microseconds(SteadyClock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+Order MakeOrder(OrderId orderId, std::mt19937_64& random)
+{
+    const auto side = orderId % 2 ? Side::Buy : Side::Sell;
+    const auto offset = static_cast<std::int32_t>(random() % 500);
+    return Order{ OrderType::GoodTillCancel, orderId, side,
+        Price{ side == Side::Buy ? 1000 - offset : 1001 + offset }, static_cast<Quantity>(1 + random() % 100) };
+}
+
+//Worst add-plus-cancel round trip seen while running is set
+SteadyClock::duration Contend(Orderbook& orderbook, OrderId firstOrderId, const std::atomic<bool>& running)
+{
+    SteadyClock::duration worst{ };
+    for (auto orderId = firstOrderId; running.load(std::memory_order_relaxed); ++orderId)
+    {
+        const auto start = SteadyClock::now();
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId, Side::Buy, Price{ 1 }, 1 }, TradeSink::Discard());
+        orderbook.CancelOrder(orderId);
+        worst = std::max(worst, SteadyClock::now() - start);
+    }
+    return worst;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t peak = argc > 1 ? std::stoul(argv[1]) : 4'000'000;
+    const std::size_t live = argc > 2 ? std::stoul(argv[2]) : 250'000;
+    const auto stride = std::max<std::size_t>(peak / std::max<std::size_t>(live, 1), 1);
+
+    OrderbookConfig config;
+    config.expectedOrders_ = peak;
+    config.bandTicks_ = 1 << 12;
+    Orderbook orderbook{ config };
+
+    std::mt19937_64 random{ 3 };
+    for (OrderId orderId = 1; orderId <= peak; ++orderId)
+        orderbook.AddOrder(MakeOrder(orderId, random), TradeSink::Discard());
+    for (OrderId orderId = 1; orderId <= peak; ++orderId)
+        if (orderId % stride)
+            orderbook.CancelOrder(orderId);
+    std::cout << peak << " orders at the peak, " << orderbook.Size() << " live" << std::endl;
+
+    {
+        OrderPool pool{ peak };
+        for (OrderId orderId = 1; orderId <= peak; ++orderId)
+            pool.Acquire(MakeOrder(orderId, random));
+
+        const auto start = SteadyClock::now();
+        const OrderPool copy = pool;
+        std::cout << "whole pool copy:        " << Microseconds(SteadyClock::now() - start) << "us" << std::endl;
+        if (copy[0].GetOrderId() != 1)
+            return 1;
+    }
+
+    SnapshotImage image;
+    {
+        const auto start = SteadyClock::now();
+        orderbook.CaptureSnapshot(image);
+        std::cout << "capture, fresh image:   " << Microseconds(SteadyClock::now() - start) << "us for "
+                  << image.orders_.size() << " orders" << std::endl;
+    }
+
+    std::atomic<bool> running{ true };
+    SteadyClock::duration quietWorst{ }, capturingWorst{ };
+    std::thread contender{ [&]{ quietWorst = Contend(orderbook, peak + 1, running); } };
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    running.store(false);
+    contender.join();
+
+    running.store(true);
+    contender = std::thread{ [&]{ capturingWorst = Contend(orderbook, 2 * peak + 1, running); } };
+
+    std::vector<SteadyClock::duration> captures;
+    for (int capture = 0; capture < 21; ++capture)
+    {
+        const auto start = SteadyClock::now();
+        orderbook.CaptureSnapshot(image);
+        captures.push_back(SteadyClock::now() - start);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    running.store(false);
+    contender.join();
+
+    std::sort(captures.begin(), captures.end());
+    std::cout << "capture, reused image:  median " << Microseconds(captures[captures.size() / 2])
+              << "us, worst " << Microseconds(captures.back()) << "us" << std::endl;
+    std::cout << "contending add+cancel:  worst " << Microseconds(quietWorst) << "us without captures, "
+              << Microseconds(capturingWorst) << "us with" << std::endl;
+}
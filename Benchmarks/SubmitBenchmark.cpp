@@ -0,0 +1,77 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "Orderbook.h"
+
+/*Throughput of one call per command against Orderbook::Submit in bursts of
+  growing size, over the same mixed flow: resting adds, cancels, modifies
+  and a share of crossing orders. Batching saves a lock hold and a snapshot
+  publication per command, and non-crossing commands skip matching either
+  way*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr std::size_t Commands{ 2'000'000 };
+
+std::vector<Command> MakeFlow()
+{
+    std::mt19937_64 random{ 5 };
+    std::vector<Command> flow;
+    flow.reserve(Commands);
+
+    for (OrderId orderId = 1; flow.size() < Commands; ++orderId)
+    {
+        const auto side = random() % 2 ? Side::Buy : Side::Sell;
+        const auto quantity = static_cast<Quantity>(1 + random() % 100);
+        const auto kind = random() % 10;
+
+        //Mostly passive prices away from 1000, one in ten crosses
+        const auto offset = static_cast<std::int32_t>(kind ? 1 + random() % 20 : 0);
+        const Price price{ side == Side::Buy ? 1000 - offset : 1000 + offset };
+
+        if (kind < 3 && orderId > 1)
+            flow.push_back(Command::Cancel(0, orderId - 1 - random() % std::min<OrderId>(orderId - 1, 1000)));
+        else if (kind < 4 && orderId > 1)
+            flow.push_back(Command::Modify(0, OrderModify{ orderId - 1, side, price, quantity }));
+        else
+            flow.push_back(Command::Add(0, Order{ OrderType::GoodTillCancel, orderId, side, price, quantity }));
+    }
+
+    return flow;
+}
+
+void Run(const std::vector<Command>& flow, std::size_t batchSize)
+{
+    Orderbook orderbook;
+    Trades trades;
+    trades.reserve(1 << 16);
+
+    const auto start = SteadyClock::now();
+    for (std::size_t first = 0; first < flow.size(); first += batchSize)
+    {
+        const auto count = std::min(batchSize, flow.size() - first);
+        if (batchSize == 1)
+            orderbook.Apply(flow[first], trades);
+        else
+            orderbook.Submit(std::span{ flow }.subspan(first, count), trades);
+
+        trades.clear();
+    }
+    const auto seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+
+    std::cout << "  batch=" << batchSize << " " << flow.size() / seconds / 1e6 << "M commands/s"
+              << " (" << orderbook.Size() << " resting)" << std::endl;
+}
+
+int main()
+{
+    const auto flow = MakeFlow();
+    std::cout << "commands=" << flow.size() << std::endl;
+
+    for (std::size_t batchSize : { 1, 8, 64, 512 })
+        Run(flow, batchSize);
+    return 0;
+}
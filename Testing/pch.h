@@ -7,4 +7,8 @@
 #include <charconv>
 #include <vector>
 #include <string>
-#include <string_view>
\ No newline at end of file
+#include <string_view>
+#include <random>
+#include <unordered_map>
+#include <future>
+#include <coroutine>
\ No newline at end of file
@@ -1,285 +1,1004 @@
 #include "pch.h" 
+#include "AsyncOrderbook.h"
+#include "BinaryScenario.h"
+#include "Clock.h"
+#include "ItchFeedHandler.h"
+#include "MatcherLoop.h"
+#include "CommandJournal.h"
 #include "Orderbook.h"    
+#include "OrderbookEngine.h"
+#include "OrderbookManager.h"
+#include "Scenario.h"
+#include "ScenarioReader.h"
+#include "SequencedOrderbook.h"
+#include "SessionScheduler.h"
+#include "SnapshotWriter.h"
+#include "TradeRing.h"
+#include "WorkStealingPool.h"
 
-enum class ActionType
-{ 
-    Add, 
-    Modify,
-    Cancel
-}; 
+ //Testing framework that each test instance inherits from
+ class OrderbookTestsFixture : public testing::TestWithParam<const char*>
+ { 
+    private:  
+        const static inline std::filesystem::path Root { 
+            std::filesystem::current_path()
+        };
+        const static inline std::filesystem::path TestFilesDir{ "Test_Files"}; 
+    public: 
+        const static inline std::filesystem::path TestFolderPath{ Root / "Testing" / TestFilesDir }; 
+ }; 
+
+ //Parametrized test to be used for every input instance 
+ TEST_P (OrderbookTestsFixture, OrderbookTestSuite) 
+ { 
+    //Arrange
+    const auto file = OrderbookTestsFixture::TestFolderPath / GetParam(); 
 
-struct Action 
-{ 
-    ActionType type_; 
-    OrderType orderType_; 
-    Side side_; 
-    Price price_; 
-    Quantity quantity_; 
-    OrderId orderId_; 
-}; 
+    const auto scenario = ScenarioParser{ }.Parse(file); 
+    ASSERT_TRUE(scenario.expected_) << "No result specified!"; 
 
-using Actions = std::vector<Action>; 
+    //Act and compare against Result, through Submit and through the per-call APIs
+    for (const auto mode : { ReplayMode::Batched, ReplayMode::PerCall })
+    { 
+        const auto outcome = ReplayScenario(scenario, { }, mode); 
+        const auto modeName = mode == ReplayMode::Batched ? "batched" : "per call"; 
+
+        ASSERT_EQ(outcome.actual_.allCount_, scenario.expected_->allCount_) << modeName; 
+        ASSERT_EQ(outcome.actual_.bidCount_, scenario.expected_->bidCount_) << modeName; 
+        ASSERT_EQ(outcome.actual_.askCount_, scenario.expected_->askCount_) << modeName; 
+    }
+
+    //And streamed from the file as it is parsed, as replay_runner reads text
+    ScenarioReader reader{ file }; 
+    const auto streamed = ReplayScenario(reader); 
+    ASSERT_TRUE(streamed.actual_ == *reader.Expected()) << "streamed"; 
+    ASSERT_EQ(streamed.commands_, scenario.commands_.size()) << "streamed"; 
+ }
 
- struct Result
+ //Creates a derived fixture instance for every specified file 
+ INSTANTIATE_TEST_SUITE_P(Tests, OrderbookTestsFixture, testing::ValuesIn({ 
+    "Cancel_MiddleOfLevel.txt",
+    "Cancel_Success.txt", 
+    "Match_FillAndKill.txt", 
+    "Match_FillOrKill_Hit.txt",
+    "Match_FillOrKill_Miss.txt", 
+    "Match_FillOrKill_MultiLevel.txt",
+    "Match_GoodTillCancel.txt",
+    "Match_Market.txt",
+    "Match_Market_Buy.txt",
+    "Match_Market_Protected.txt",
+    "Match_OutsideBand.txt",
+    "Modify_Price.txt", 
+    "Modify_QuantityDown.txt",
+    "Modify_QuantityUp.txt",
+    "Modify_Side.txt",
+    "NoMatch_GoodTillCancel.txt"
+    })); 
+  
+ TEST(OrderPoolTests, ReleasedSlotIsReused)
  { 
-    std::size_t allCount_; 
-    std::size_t bidCount_; 
-    std::size_t askCount_; 
- };
+    OrderPool pool; 
+    const auto index = pool.Acquire(Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }); 
+    ASSERT_EQ(pool[index].GetOrderId(), OrderId{ 1 }); 
+
+    pool.Release(index); 
+    const auto reused = pool.Acquire(Order{ OrderType::GoodTillCancel, 2, Side::Sell, Price{ 101 }, 5 }); 
+
+    ASSERT_EQ(reused, index); 
+    ASSERT_EQ(pool[reused].GetOrderId(), OrderId{ 2 }); 
+ }
 
- struct InputHandler
+ //Random inserts and erases must agree with std::unordered_map in both modes
+ TEST(OrderIdIndexTests, MatchesUnorderedMap)
  { 
-    private: 
-        std::uint64_t ToNumber(const std::string_view& str) const 
-        { 
-            std::int64_t value{}; 
-            std::from_chars(str.data(), str.data() + str.size(), value); 
+    for (auto mode : { OrderIdIndex<OrderId>::Mode::Hashed, OrderIdIndex<OrderId>::Mode::Dense })
+    { 
+        OrderIdIndex<OrderId> index{ mode, 16 }; 
+        std::unordered_map<OrderId, OrderId> expected; 
+        std::mt19937_64 random{ 7 }; 
 
-            if (value < 0)
-                throw std::logic_error("Only non-negative values allowed!"); 
-            return static_cast<std::uint64_t> (value); 
+        for (OrderId step = 0; step < 200'000; ++step)
+        { 
+            const OrderId orderId = step + 512 - random() % 512; 
+            if (random() % 2)
+                ASSERT_EQ(index.Insert(orderId, step), expected.emplace(orderId, step).second); 
+            else
+                ASSERT_EQ(index.Erase(orderId), expected.erase(orderId) == 1); 
         }
 
-        std::vector<std::string_view> Split(const std::string_view& str, 
-            char delimiter) const
-        { 
-            std::vector<std::string_view> columns{ }; 
-            std::size_t startIndex{ }, endIndex{ }; 
-            while ((endIndex = str.find(delimiter, startIndex)) && 
-                   endIndex != std::string::npos)
-            { 
-                auto partLen = endIndex - startIndex; 
-                columns.push_back(str.substr(startIndex, partLen)); 
-                startIndex = endIndex+1; 
-            }
+        ASSERT_EQ(index.Size(), expected.size()); 
+        for (const auto& [orderId, value] : expected)
+            ASSERT_EQ(*index.Find(orderId), value); 
+    }
+ }
 
-            columns.push_back(str.substr(startIndex)); 
-            return columns; 
-        }
+ //The id index reserves the largest id, so the book must refuse it rather than rest it unfindable
+ TEST(OrderIdIndexTests, BookRejectsTheReservedId)
+ { 
+    constexpr OrderId reserved{ std::numeric_limits<OrderId>::max() }; 
+    Orderbook orderbook; 
+
+    ASSERT_FALSE(orderbook.Apply(Command::Add(0, Order{ OrderType::GoodTillCancel, reserved, Side::Buy, Price{ 100 }, 10 }), 
+        TradeSink::Discard())); 
+    ASSERT_EQ(orderbook.Size(), 0u); 
+    ASSERT_TRUE(orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Sell, Price{ 100 }, 10 }).empty()); 
+    ASSERT_EQ(orderbook.Size(), 1u); 
+ }
+
+ TEST(FixedPriceTests, ParsesScaledDecimals)
+ { 
+    using CentPrice = FixedPrice<std::int64_t, 5, 2>; 
+
+    ASSERT_EQ(CentPrice::FromString("101.25")->Units(), 10125); 
+    ASSERT_EQ(CentPrice::FromString("-3.5")->Units(), -350); 
+    ASSERT_EQ(CentPrice::FromString("7")->Ticks(), 140); 
+    ASSERT_FALSE(CentPrice::FromString("1.255")); 
+    ASSERT_FALSE(CentPrice::FromString("1.")); 
+    ASSERT_FALSE(CentPrice::FromString("abc")); 
+    ASSERT_FALSE(CentPrice::FromString("99999999999999999999")); 
+    ASSERT_LT(CentPrice::None(), *CentPrice::FromString("-1000")); 
+    ASSERT_EQ(sizeof(Price), sizeof(std::int32_t)); 
+ }
+
+ TEST(TradeSinkTests, FillsReachCallerSinks)
+ { 
+    Orderbook orderbook; 
+    TradeRing<4> ring; 
+
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }, ring); 
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 2, Side::Buy, Price{ 101 }, 10 }, ring); 
+    ASSERT_TRUE(ring.Empty()); 
+
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 3, Side::Sell, Price{ 100 }, 15 }, ring); 
+    ASSERT_EQ(ring.Size(), 2u); 
+    ASSERT_EQ(ring[0].GetBidTrade().orderId_, OrderId{ 2 }); 
+    ASSERT_EQ(ring[1].GetBidTrade().quantity_, Quantity{ 5 }); 
+
+    Quantity filled{ }; 
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 4, Side::Sell, Price{ 100 }, 5 }, 
+        [&filled](const Trade& trade) { filled += trade.GetAskTrade().quantity_; }); 
+    ASSERT_EQ(filled, Quantity{ 5 }); 
+    ASSERT_EQ(orderbook.Size(), 0u); 
+ }
+
+ TEST(MarketOrderTests, SweepStopsAtConfiguredLevelCount)
+ { 
+    OrderbookConfig config; 
+    config.marketSweepLevels_ = 2; 
+    Orderbook orderbook{ config }; 
+
+    for (OrderId orderId = 1; orderId <= 3; ++orderId)
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId, Side::Sell, 
+            Price{ 100 + static_cast<std::int32_t>(orderId) }, 10 }); 
+
+    const auto trades = orderbook.AddOrder(Order{ 4, Side::Buy, 50 }); 
+
+    ASSERT_EQ(trades.size(), 2u); 
+    ASSERT_EQ(trades[1].GetBidTrade().price_, Price{ 102 }); 
+    ASSERT_EQ(orderbook.Size(), 1u); 
+ }
 
-        bool ParseResult(const std::string_view& str, Result& result) const 
+ //A market order that found nothing to take did not change the book
+ TEST(MarketOrderTests, UnfilledMarketOrderIsNotAChange)
+ { 
+    Orderbook orderbook; 
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }); 
+
+    ASSERT_FALSE(orderbook.Apply(Command::Add(0, Order{ 2, Side::Buy, 10 }), TradeSink::Discard())); 
+    ASSERT_EQ(orderbook.LastSequence(), 1u); 
+
+    ASSERT_TRUE(orderbook.Apply(Command::Add(0, Order{ 3, Side::Sell, 4 }), TradeSink::Discard())); 
+    ASSERT_EQ(orderbook.LastSequence(), 2u); 
+ }
+
+ TEST(OrderbookManagerTests, RoutesCommandsToEachSymbolsBook)
+ { 
+    std::mutex tradesMutex; 
+    std::unordered_map<SymbolId, Quantity> tradedQuantity; 
+
+    OrderbookManager manager{ 4, OrderbookConfig{ }, [&](SymbolId symbolId, const Trade& trade)
+    { 
+        std::scoped_lock tradesLock{ tradesMutex }; 
+        tradedQuantity[symbolId] += trade.GetBidTrade().quantity_; 
+    } }; 
+
+    //Same order ids and prices on every symbol, books must stay independent
+    for (SymbolId symbolId = 0; symbolId < 64; ++symbolId)
+    { 
+        manager.Submit(Command::Add(symbolId, Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 })); 
+        manager.Submit(Command::Add(symbolId, Order{ OrderType::GoodTillCancel, 2, Side::Sell, Price{ 100 }, symbolId % 10 + 1 })); 
+        manager.Submit(Command::Add(symbolId, Order{ OrderType::GoodTillCancel, 3, Side::Sell, Price{ 105 }, 10 })); 
+        if (symbolId % 2)
+            manager.Submit(Command::Cancel(symbolId, 3)); 
+        else 
+            manager.Submit(Command::Modify(symbolId, OrderModify{ 3, Side::Sell, Price{ 105 }, 5 })); 
+    }
+    manager.Flush(); 
+
+    for (SymbolId symbolId = 0; symbolId < 64; ++symbolId)
+    { 
+        const Quantity traded = symbolId % 10 + 1; 
+        const std::size_t resting = (traded < 10 ? 1 : 0) + (symbolId % 2 ? 0 : 1); 
+
+        ASSERT_EQ(tradedQuantity[symbolId], traded); 
+        ASSERT_EQ(manager.Size(symbolId), resting); 
+    }
+    ASSERT_EQ(manager.Size(1000), 0u); 
+ }
+
+ TEST(OrderbookEngineTests, ClientsReceiveTheirFillsThenDone)
+ { 
+    OrderbookEngine engine{ 2 }; 
+
+    auto Await = [&engine](std::size_t client)
+    { 
+        std::vector<OrderbookEngine::Response> responses; 
+        OrderbookEngine::Response response; 
+        do 
         { 
-            if (str[0] != 'R')
-                return false; 
-            
-            auto values = Split(str, ' ');
-            result.allCount_ = ToNumber(values[1]); 
-            result.bidCount_ = ToNumber(values[2]); 
-            result.askCount_ = ToNumber(values[3]); 
-            
-            return true; 
-        }
+            while (!engine.TryPoll(client, response))
+                std::this_thread::yield(); 
+            responses.push_back(response); 
+        } while (response.kind_ != OrderbookEngine::Response::Kind::Done); 
+        return responses; 
+    }; 
 
-        bool ParseInfoLine(const std::string_view& str, Action& info) const 
-        {
-            auto values = Split(str, ' '); 
-            auto actionType = values[0]; 
-            if (actionType == "A")
-            { 
-                info.type_ = ActionType::Add; 
-                info.side_ = ParseSide(values[1]); 
-                info.orderType_ = ParseOrderType(values[2]); 
-                info.price_ = ParsePrice(values[3]); 
-                info.quantity_ = ParseQuantity(values[4]); 
-                info.orderId_ = ParseOrderId(values[5]); 
-            }
-            else if (actionType == "M")
+    ASSERT_TRUE(engine.TrySubmit(0, Command::Add(0, Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }), 7)); 
+    const auto resting = Await(0); 
+    ASSERT_EQ(resting.size(), 1u); 
+    ASSERT_EQ(resting[0].tag_, 7u); 
+
+    ASSERT_TRUE(engine.TrySubmit(1, Command::Add(0, Order{ OrderType::GoodTillCancel, 2, Side::Sell, Price{ 99 }, 4 }), 8)); 
+    const auto crossing = Await(1); 
+    ASSERT_EQ(crossing.size(), 2u); 
+    ASSERT_EQ(crossing[0].kind_, OrderbookEngine::Response::Kind::Fill); 
+    ASSERT_EQ(crossing[0].tag_, 8u); 
+    ASSERT_EQ(crossing[0].trade_.GetBidTrade().orderId_, 1u); 
+    ASSERT_EQ(crossing[0].trade_.GetAskTrade().quantity_, 4u); 
+
+    ASSERT_TRUE(engine.TrySubmit(0, Command::Cancel(0, 1), 9)); 
+    ASSERT_EQ(Await(0).size(), 1u); 
+ }
+
+ //hour:minute local time on a trading day, for tests that cross the 4PM close
+ std::chrono::system_clock::time_point TradingDayAt(int hour, int minute)
+ { 
+    std::tm parts{ }; 
+    parts.tm_year = 2026 - 1900; 
+    parts.tm_mon = 2; 
+    parts.tm_mday = 2; 
+    parts.tm_hour = hour; 
+    parts.tm_min = minute; 
+    parts.tm_isdst = -1; 
+    return std::chrono::system_clock::from_time_t(std::mktime(&parts)); 
+ }
+
+ //The engine reads the clock between busy passes too, so the close is never missed under load
+ TEST(OrderbookEngineTests, ExpiresGoodForDayOrdersAtTheCloseUnderLoad)
+ { 
+    SimulatedClock clock{ TradingDayAt(15, 59) }; 
+    OrderbookConfig config; 
+    config.clock_ = &clock; 
+    OrderbookEngine engine{ 1, config }; 
+
+    //Keeps requests queued ahead of the engine, calls halfway once half are done. Returns the fills
+    auto Pump = [&engine](const Command& command, std::size_t count, const std::function<void()>& halfway)
+    { 
+        std::size_t submitted{ }, done{ }, fills{ }; 
+        OrderbookEngine::Response response; 
+        while (done < count)
+        { 
+            if (submitted < count && engine.TrySubmit(0, command, submitted))
+                ++submitted; 
+            while (engine.TryPoll(0, response))
             { 
-                info.type_ = ActionType::Modify; 
-                info.orderId_ = ParseOrderId(values[1]); 
-                info.side_ = ParseSide(values[2]); 
-                info.price_ = ParsePrice(values[3]); 
-                info.quantity_ = ParseQuantity(values[4]); 
-            }
-            else if (actionType == "C")
-            {
-                info.type_ = ActionType::Cancel; 
-                info.orderId_ = ParseOrderId(values[1]); 
+                if (response.kind_ == OrderbookEngine::Response::Kind::Fill)
+                    ++fills; 
+                else if (++done == count / 2 && halfway)
+                    halfway(); 
             }
-            else 
-                return false; 
-            
-            return true; 
         }
+        return fills; 
+    }; 
+
+    Pump(Command::Add(0, Order{ OrderType::GoodForDay, 1, Side::Buy, Price{ 100 }, 10 }), 1, nullptr); 
+    Pump(Command::Cancel(0, 2), 8 * MatcherLoop::PassesPerCheck, [&clock]{ clock.AdvanceTo(TradingDayAt(16, 1)); }); 
 
-        Side ParseSide(const std::string_view& str) const 
+    //The GoodForDay bid is gone, so nothing is left to sell into
+    ASSERT_EQ(Pump(Command::Add(0, Order{ OrderType::GoodTillCancel, 3, Side::Sell, Price{ 100 }, 10 }), 1, nullptr), 0u); 
+ }
+
+ TEST(BookSnapshotTests, ReadersSeeWholeEventsWithoutTheLock)
+ { 
+    Orderbook orderbook; 
+    std::atomic<bool> done{ false }; 
+    std::size_t torn{ }; 
+
+    //Fewer levels than MaxDepth rest, so every snapshot holds the whole book
+    std::thread reader{ [&]
+    { 
+        while (!done.load())
         { 
-            if (str == "B")
-                return Side::Buy; 
-            else if (str == "S")
-                return Side::Sell; 
-            else 
-                throw std::logic_error("Invalid Side!"); 
+            const auto snapshot = orderbook.GetSnapshot(); 
+            std::uint64_t orderCount{ }; 
+            for (std::size_t level = 0; level < snapshot.bidDepth_; ++level)
+                orderCount += snapshot.bids_[level].orderCount_; 
+            for (std::size_t level = 0; level < snapshot.askDepth_; ++level)
+                orderCount += snapshot.asks_[level].orderCount_; 
+
+            if (orderCount != snapshot.orderCount_)
+                ++torn; 
         }
+    } }; 
+
+    std::mt19937 random{ 3 }; 
+    for (OrderId orderId = 1; orderId <= 20000; ++orderId)
+    { 
+        const auto side = random() % 2 ? Side::Buy : Side::Sell; 
+        const auto offset = static_cast<std::int32_t>(1 + random() % 5); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId, side, 
+            Price{ side == Side::Buy ? 100 - offset : 100 + offset }, static_cast<Quantity>(1 + random() % 10) }); 
+
+        if (orderId > 50)
+            orderbook.CancelOrder(orderId - 50); 
+    }
+    done.store(true); 
+    reader.join(); 
+
+    const auto snapshot = orderbook.GetSnapshot(); 
+    ASSERT_EQ(torn, 0u); 
+    ASSERT_EQ(snapshot.orderCount_, 50u); 
+    ASSERT_EQ(snapshot.sequence_, 20000u + 19950u); 
+    ASSERT_LT(snapshot.BestBid(), Price{ 100 }); 
+    ASSERT_GT(snapshot.BestAsk(), Price{ 100 }); 
+ }
+
+ //Levels far apart, out to both ends of the band, must still publish best first
+ TEST(BookSnapshotTests, SparseLevelsPublishInPriceOrder)
+ { 
+    OrderbookConfig config; 
+    config.referencePrice_ = Price{ 5000 }; 
+    Orderbook orderbook{ config }; 
+
+    //The band spans prices 2952 to 7047
+    std::vector<Price> bids{ Price{ 2952 } }, asks{ Price{ 7047 } }; 
+    for (std::int32_t level = 0; level < 12; ++level)
+    { 
+        bids.push_back(Price{ 4990 - 97 * level }); 
+        asks.push_back(Price{ 5010 + 131 * level }); 
+    }
+
+    OrderId orderId{ 1 }; 
+    for (const auto price : bids)
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId++, Side::Buy, price, 10 }); 
+    for (const auto price : asks)
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId++, Side::Sell, price, 10 }); 
+
+    std::sort(bids.begin(), bids.end(), std::greater<Price>{ }); 
+    std::sort(asks.begin(), asks.end()); 
+    auto snapshot = orderbook.GetSnapshot(); 
+    ASSERT_EQ(snapshot.bidDepth_, BookSnapshot::MaxDepth); 
+    ASSERT_EQ(snapshot.askDepth_, BookSnapshot::MaxDepth); 
+    for (std::size_t level = 0; level < BookSnapshot::MaxDepth; ++level)
+    { 
+        ASSERT_EQ(snapshot.bids_[level].price_, bids[level]); 
+        ASSERT_EQ(snapshot.asks_[level].price_, asks[level]); 
+    }
+
+    //Emptying every level but the band's edges leaves just those
+    for (OrderId cancelled = 2; cancelled < orderId; ++cancelled)
+        if (cancelled != 14)
+            orderbook.CancelOrder(cancelled); 
+
+    snapshot = orderbook.GetSnapshot(); 
+    ASSERT_EQ(snapshot.bidDepth_, 1u); 
+    ASSERT_EQ(snapshot.askDepth_, 1u); 
+    ASSERT_EQ(snapshot.BestBid(), Price{ 2952 }); 
+    ASSERT_EQ(snapshot.BestAsk(), Price{ 7047 }); 
+ }
+
+ TEST(GoodForDayExpiryTests, ExpiresOnlyRestingGoodForDayOrdersInChunks)
+ { 
+    OrderbookConfig config; 
+    config.expiryChunkSize_ = 3; 
+    Orderbook orderbook{ config }; 
+
+    for (OrderId orderId = 1; orderId <= 20; ++orderId)
+        orderbook.AddOrder(Order{ orderId % 2 ? OrderType::GoodForDay : OrderType::GoodTillCancel, 
+            orderId, Side::Buy, Price{ 90 + static_cast<std::int32_t>(orderId % 5) }, 10 }); 
+
+    //Leaves the expiry list through a fill, a cancel and a modify
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 21, Side::Sell, Price{ 94 }, 20 }); 
+    orderbook.CancelOrder(3); 
+    orderbook.ModifyOrder(OrderModify{ 5, Side::Buy, Price{ 80 }, 5 }); 
+    ASSERT_EQ(orderbook.Size(), 17u); 
+
+    orderbook.PruneGoodForDayOrdersNow(); 
+
+    const auto orderbookLevelInfos = orderbook.GetOrderInfos(); 
+    ASSERT_EQ(orderbook.Size(), 9u); 
+    ASSERT_EQ(orderbookLevelInfos.GetBidCount(), 9u); 
+    for (const auto& level : orderbookLevelInfos.GetBidInfos())
+        ASSERT_NE(level.price_, Price{ 80 }); 
+
+    orderbook.PruneGoodForDayOrdersNow(); 
+    ASSERT_EQ(orderbook.Size(), 9u); 
+ }
+
+ TEST(SessionSchedulerTests, RunsDueTasksInTimeOrderAndSkipsCancelled)
+ { 
+    using namespace std::chrono; 
+
+    SessionScheduler scheduler; 
+    std::mutex ranMutex; 
+    std::vector<int> ran; 
+    auto Record = [&](int task) { return [&, task]{ std::scoped_lock ranLock{ ranMutex }; ran.push_back(task); }; }; 
+
+    const auto now = system_clock::now(); 
+    scheduler.ScheduleAt(now + milliseconds(30), Record(3)); 
+    const auto cancelled = scheduler.ScheduleAt(now + milliseconds(20), Record(2)); 
+    scheduler.ScheduleAt(now - milliseconds(10), Record(1)); 
+    ASSERT_TRUE(scheduler.Cancel(cancelled)); 
+
+    auto RanCount = [&] { std::scoped_lock ranLock{ ranMutex }; return ran.size(); }; 
+    for (auto waited = 0; RanCount() < 2 && waited < 200; ++waited)
+        std::this_thread::sleep_for(milliseconds(5)); 
+
+    std::scoped_lock ranLock{ ranMutex }; 
+    ASSERT_EQ(ran, (std::vector<int>{ 1, 3 })); 
+    ASSERT_EQ(scheduler.Pending(), 0u); 
+    ASSERT_FALSE(scheduler.Cancel(cancelled)); 
+ }
+
+ TEST(SessionSchedulerTests, BooksRegisterExpiryOnlyWhileGoodForDayOrdersRest)
+ { 
+    SessionScheduler scheduler; 
+    WallClock clock{ scheduler }; 
+    OrderbookConfig config; 
+    config.clock_ = &clock; 
+
+    { 
+        Orderbook orderbook{ config }; 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }); 
+        ASSERT_EQ(scheduler.Pending(), 0u); 
 
-        OrderType ParseOrderType(const std::string_view& str) const 
+        orderbook.AddOrder(Order{ OrderType::GoodForDay, 2, Side::Buy, Price{ 100 }, 10 }); 
+        orderbook.AddOrder(Order{ OrderType::GoodForDay, 3, Side::Buy, Price{ 100 }, 10 }); 
+        ASSERT_EQ(scheduler.Pending(), 1u); 
+    }
+
+    //Destroying the book withdraws its expiry
+    ASSERT_EQ(scheduler.Pending(), 0u); 
+ }
+
+ TEST(SimulatedClockTests, ReplayedDayExpiresGoodForDayOrdersAtTheClose)
+ { 
+    using namespace std::chrono; 
+
+    //09:30 local time on a trading day
+    std::tm open{ }; 
+    open.tm_year = 2026 - 1900; 
+    open.tm_mon = 2; 
+    open.tm_mday = 2; 
+    open.tm_hour = 9; 
+    open.tm_min = 30; 
+    open.tm_isdst = -1; 
+    const auto sessionOpen = system_clock::from_time_t(std::mktime(&open)); 
+
+    SimulatedClock clock{ sessionOpen }; 
+    OrderbookConfig config; 
+    config.clock_ = &clock; 
+    Orderbook orderbook{ config }; 
+
+    orderbook.AddOrder(Order{ OrderType::GoodForDay, 1, Side::Buy, Price{ 100 }, 10 }); 
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 2, Side::Buy, Price{ 99 }, 10 }); 
+    clock.AdvanceTo(sessionOpen + hours(6)); 
+    orderbook.AddOrder(Order{ OrderType::GoodForDay, 3, Side::Sell, Price{ 105 }, 10 }); 
+    ASSERT_EQ(orderbook.Size(), 3u); 
+    ASSERT_EQ(clock.Pending(), 1u); 
+
+    //Crossing 16:00 fires the expiry inline, before AdvanceTo returns
+    clock.AdvanceTo(sessionOpen + hours(7)); 
+    ASSERT_EQ(orderbook.Size(), 1u); 
+    ASSERT_EQ(clock.Pending(), 0u); 
+
+    //The next day's GoodForDay order expires at the next day's close
+    clock.AdvanceTo(sessionOpen + hours(24)); 
+    orderbook.AddOrder(Order{ OrderType::GoodForDay, 4, Side::Buy, Price{ 98 }, 10 }); 
+    clock.AdvanceTo(sessionOpen + hours(30)); 
+    ASSERT_EQ(orderbook.Size(), 2u); 
+    clock.AdvanceTo(sessionOpen + hours(31)); 
+    ASSERT_EQ(orderbook.Size(), 1u); 
+ }
+
+ TEST(SubmitTests, BatchMatchesOneCallPerCommand)
+ { 
+    std::mt19937 random{ 11 }; 
+    std::vector<Command> commands; 
+    for (OrderId orderId = 1; orderId <= 5000; ++orderId)
+    { 
+        const auto side = random() % 2 ? Side::Buy : Side::Sell; 
+        const Price price{ 95 + static_cast<std::int32_t>(random() % 11) }; 
+        const auto quantity = static_cast<Quantity>(1 + random() % 20); 
+
+        switch (random() % 4)
         { 
-            if (str == "GoodTillCancel")
-                return OrderType::GoodTillCancel; 
-            else if (str == "GoodForDay")
-                return OrderType::GoodForDay; 
-            else if (str == "FillAndKill")
-                return OrderType::FillAndKill; 
-            else if (str == "FillOrKill")
-                return OrderType::FillOrKill; 
-            else if (str == "Market")
-                return OrderType::Market; 
-            else 
-                throw std::logic_error("Invalid order type!"); 
+            case 0: 
+                commands.push_back(Command::Cancel(0, 1 + random() % orderId)); 
+                break; 
+            case 1: 
+                commands.push_back(Command::Modify(0, OrderModify{ 1 + random() % orderId, side, price, quantity })); 
+                break; 
+            default: 
+                commands.push_back(Command::Add(0, Order{ random() % 5 ? OrderType::GoodTillCancel : OrderType::FillAndKill, 
+                    orderId, side, price, quantity })); 
         }
+    }
 
-        Price ParsePrice(const std::string_view& str) const 
-        { 
-            if (str.empty())
-                throw std::logic_error("Invalid Price"); 
+    Orderbook batched, called; 
+    Trades batchedTrades, calledTrades; 
+    for (std::size_t first = 0; first < commands.size(); first += 64)
+        batched.Submit(std::span{ commands }.subspan(first, std::min<std::size_t>(64, commands.size() - first)), batchedTrades); 
+    for (const auto& command : commands)
+        called.Apply(command, calledTrades); 
 
-            return ToNumber(str); 
-        }
+    ASSERT_EQ(batchedTrades.size(), calledTrades.size()); 
+    for (std::size_t trade = 0; trade < calledTrades.size(); ++trade)
+    { 
+        ASSERT_EQ(batchedTrades[trade].GetBidTrade().orderId_, calledTrades[trade].GetBidTrade().orderId_); 
+        ASSERT_EQ(batchedTrades[trade].GetAskTrade().orderId_, calledTrades[trade].GetAskTrade().orderId_); 
+        ASSERT_EQ(batchedTrades[trade].GetBidTrade().quantity_, calledTrades[trade].GetBidTrade().quantity_); 
+    }
+
+    const auto batchedInfos = batched.GetOrderInfos(); 
+    const auto calledInfos = called.GetOrderInfos(); 
+    ASSERT_EQ(batched.Size(), called.Size()); 
+    ASSERT_EQ(batchedInfos.GetBidInfos().size(), calledInfos.GetBidInfos().size()); 
+    ASSERT_EQ(batchedInfos.GetAskInfos().size(), calledInfos.GetAskInfos().size()); 
+    ASSERT_EQ(batchedInfos.GetBidCount(), calledInfos.GetBidCount()); 
+    ASSERT_EQ(batched.GetSnapshot().BestAsk(), called.GetSnapshot().BestAsk()); 
+ }
 
-        Quantity ParseQuantity(const std::string_view& str) const 
-        { 
-            if (str.empty())
-                throw std::logic_error(std::format("Invalid Quantity: {}", str));  
+ struct DetachedTestCoroutine 
+ { 
+    struct promise_type 
+    { 
+        DetachedTestCoroutine get_return_object() { return { }; }
+        std::suspend_never initial_suspend() noexcept { return { }; }
+        std::suspend_never final_suspend() noexcept { return { }; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    }; 
+ }; 
 
-            return ToNumber(str); 
-        }
+ TEST(AsyncOrderbookTests, ReportsReachCallbacksAndCoroutines)
+ { 
+    std::promise<ExecutionReport> callbackReport; 
+    std::promise<std::vector<ExecutionReport>> coroutineReports; 
+
+    { 
+        AsyncOrderbook orderbook; 
+        orderbook.Submit(Command::Add(0, Order{ OrderType::GoodTillCancel, 1, Side::Sell, Price{ 100 }, 10 }), 
+            [&](ExecutionReport&& report){ callbackReport.set_value(std::move(report)); }); 
 
-        OrderId ParseOrderId(const std::string_view& str) const 
+        [](AsyncOrderbook& orderbook, std::promise<std::vector<ExecutionReport>>& reports) -> DetachedTestCoroutine
         { 
-            if (str.empty())
-                throw std::logic_error("Invalid OrderId"); 
+            std::vector<ExecutionReport> received; 
+            received.push_back(co_await orderbook.Execute(Command::Add(0, Order{ OrderType::GoodTillCancel, 2, Side::Buy, Price{ 100 }, 4 }))); 
+            received.push_back(co_await orderbook.Execute(Command::Cancel(0, 2))); 
+            received.push_back(co_await orderbook.Execute(Command::Cancel(0, 1))); 
+            reports.set_value(std::move(received)); 
+        }(orderbook, coroutineReports); 
+    }
+
+    const auto resting = callbackReport.get_future().get(); 
+    ASSERT_TRUE(resting.applied_); 
+    ASSERT_TRUE(resting.trades_.empty()); 
+
+    const auto reports = coroutineReports.get_future().get(); 
+    ASSERT_EQ(reports.size(), 3u); 
+    ASSERT_EQ(reports[0].trades_.size(), 1u); 
+    ASSERT_EQ(reports[0].trades_[0].GetAskTrade().orderId_, 1u); 
+    ASSERT_FALSE(reports[1].applied_); 
+    ASSERT_TRUE(reports[2].applied_); 
+ }
 
-            return ToNumber(str); 
-        }
+ //Nothing need be queued, the close itself wakes the executor
+ TEST(AsyncOrderbookTests, ExpiresGoodForDayOrdersAtTheClose)
+ { 
+    SimulatedClock clock{ TradingDayAt(15, 59) }; 
+    OrderbookConfig config; 
+    config.clock_ = &clock; 
+    AsyncOrderbook orderbook{ config }; 
 
-    public: 
-        
-        std::tuple<Actions, Result> GetInputInfo(
-            const std::filesystem::path& path) const
-        { 
-            Actions actions; 
-            actions.reserve(1000); 
+    auto Execute = [&orderbook](const Command& command)
+    { 
+        std::promise<ExecutionReport> report; 
+        orderbook.Submit(command, [&report](ExecutionReport&& executed){ report.set_value(std::move(executed)); }); 
+        return report.get_future().get(); 
+    }; 
 
-            std::string line; 
-            std::ifstream file{ path }; 
+    ASSERT_TRUE(Execute(Command::Add(0, Order{ OrderType::GoodForDay, 1, Side::Buy, Price{ 100 }, 10 })).applied_); 
+    clock.AdvanceTo(TradingDayAt(16, 1)); 
 
-            while (std::getline(file, line)) 
+    //Queued after the close, so applied only once the bid has expired
+    ASSERT_TRUE(Execute(Command::Add(0, Order{ OrderType::GoodTillCancel, 2, Side::Sell, Price{ 100 }, 10 })).trades_.empty()); 
+    ASSERT_FALSE(Execute(Command::Cancel(0, 1)).applied_); 
+ }
+
+ //Tasks submitted from tasks land on the submitting thread, idle threads must steal them
+ TEST(WorkStealingPoolTests, RunsNestedTasksAndSteals)
+ { 
+    std::atomic<std::size_t> ran{ 0 }; 
+    WorkStealingPool pool{ 4 }; 
+
+    pool.Submit([&]
+    { 
+        for (int task = 0; task < 1000; ++task)
+            pool.Submit([&]
             { 
-                if (line.empty())
-                    break; 
-
-                const bool isResult = (line[0] == 'R'); 
-                const bool isAction = !isResult; 
-
-                if (isAction)
-                { 
-                    Action action; 
-
-                    auto isValid = ParseInfoLine(line, action); 
-                    if (!isValid)
-                        throw std::logic_error(std::format(
-                            "Invalid action: {}", line
-                        )); 
-                
-                    actions.push_back(action); 
-                }
-                else 
-                { 
-                    if (!file.eof())
-                        throw std::logic_error("Result line must be at end of file!");
-
-                    Result result; 
-                    ParseResult(line, result); 
-    
-                    return { actions, result}; 
-                }
-            }
+                std::this_thread::sleep_for(std::chrono::microseconds{ 10 }); 
+                ran.fetch_add(1); 
+            }); 
+    }); 
+    pool.Wait(); 
+
+    ASSERT_EQ(ran.load(), 1000u); 
+    ASSERT_GT(pool.Steals(), 0u); 
+ }
+
+ //Commands come straight out of the text, the R line ends them and a bad line is named
+ TEST(ScenarioReaderTests, ReadsInPlaceAndNamesBadLines)
+ { 
+    ScenarioReader reader{ std::string_view{ "A B GoodTillCancel 100 10 1\r\nM 1 S 101 5\nC 1\nR 0 0 0\n\n" } }; 
+    std::vector<Command> commands; 
+    for (const auto& command : reader)
+        commands.push_back(command); 
+
+    ASSERT_EQ(commands.size(), 3u); 
+    ASSERT_EQ(commands[0].kind_, Command::Kind::Add); 
+    ASSERT_EQ(commands[0].price_, Price{ 100 }); 
+    ASSERT_EQ(commands[0].quantity_, 10u); 
+    ASSERT_EQ(commands[1].kind_, Command::Kind::Modify); 
+    ASSERT_EQ(commands[1].side_, Side::Sell); 
+    ASSERT_EQ(commands[2].orderId_, 1u); 
+    ASSERT_EQ(reader.Expected(), (ScenarioResult{ 0, 0, 0 })); 
+
+    ScenarioReader badLine{ std::string_view{ "C 1\nA B GoodTillCancel 100 -5 2\n" } }; 
+    try
+    { 
+        for ([[maybe_unused]] const auto& command : badLine) { } 
+        FAIL() << "Negative quantity was accepted"; 
+    }
+    catch (const std::logic_error& error)
+    { 
+        ASSERT_TRUE(std::string_view{ error.what() }.starts_with("Line 2:")); 
+    }
+ }
+
+ //Every test scenario converts to binary with the same commands and result, and replays alike
+ TEST(BinaryScenarioTests, MatchesTextScenarios)
+ { 
+    const auto path = std::filesystem::temp_directory_path() / "orderbook_binary_scenario_test.bin"; 
+
+    for (const auto& entry : std::filesystem::directory_iterator{ OrderbookTestsFixture::TestFolderPath })
+    { 
+        const auto text = ScenarioParser{ }.Parse(entry.path()); 
+        ScenarioReader reader{ entry.path() }; 
+        WriteBinaryScenario(path, reader); 
 
-            throw std::logic_error("No result specified!"); 
+        ASSERT_TRUE(IsBinaryScenario(path)); 
+        ASSERT_FALSE(IsBinaryScenario(entry.path())); 
+
+        const BinaryScenarioReader binary{ path }; 
+        ASSERT_EQ(binary.Commands().size(), text.commands_.size()) << entry.path(); 
+        ASSERT_TRUE(std::ranges::equal(binary.Commands(), text.commands_)); 
+        ASSERT_EQ(binary.Expected(), text.expected_); 
+
+        const auto outcome = ReplayScenario(binary.Commands()); 
+        ASSERT_EQ(outcome.actual_, ReplayScenario(text).actual_); 
+        ASSERT_TRUE(outcome.Passed(text)); 
+    }
+
+    std::filesystem::remove(path); 
+ }
+
+ //A count whose byte size wraps around to the file's size must not pass for it
+ TEST(BinaryScenarioTests, RejectsCountsThatOverflow)
+ { 
+    const auto path = std::filesystem::temp_directory_path() / "orderbook_binary_overflow_test.bin"; 
+    ScenarioReader reader{ std::string_view{ "A B GoodTillCancel 100 10 1\nC 1\n" } }; 
+    WriteBinaryScenario(path, reader); 
+
+    //The count follows the 8 byte magic and two 4 byte fields
+    std::uint64_t commandCount{ }; 
+    std::fstream file{ path, std::ios::in | std::ios::out | std::ios::binary }; 
+    file.seekg(16); 
+    file.read(reinterpret_cast<char*>(&commandCount), sizeof(commandCount)); 
+    ASSERT_EQ(commandCount, 2u); 
+
+    commandCount += std::numeric_limits<std::uint64_t>::max() / sizeof(Command) + 1; 
+    ASSERT_EQ(commandCount * sizeof(Command), 2 * sizeof(Command)); 
+    file.seekp(16); 
+    file.write(reinterpret_cast<const char*>(&commandCount), sizeof(commandCount)); 
+    file.close(); 
+
+    ASSERT_THROW(BinaryScenarioReader{ path }, std::logic_error); 
+    std::filesystem::remove(path); 
+ }
+
+ //Sequence numbers are dense and keep each producer's own submission order
+ TEST(MpscSequencerTests, OrdersConcurrentProducers)
+ { 
+    constexpr std::uint64_t PerProducer{ 20'000 }; 
+    MpscSequencer<std::uint64_t, 64> sequencer; 
+    std::vector<std::thread> producers; 
+
+    for (std::uint64_t producer = 0; producer < 4; ++producer)
+        producers.emplace_back([&sequencer, producer]
+        { 
+            bool stalled; 
+            for (std::uint64_t index = 0; index < PerProducer; ++index)
+                sequencer.Publish((producer << 32) | index, stalled); 
+        }); 
+
+    std::vector<std::uint64_t> nextIndex(4, 0); 
+    for (std::uint64_t expected = 1; expected <= 4 * PerProducer; )
+    { 
+        std::uint64_t value, sequence; 
+        if (!sequencer.TryConsume(value, sequence))
+        { 
+            std::this_thread::yield(); 
+            continue; 
         }
- }; 
 
- //Testing framework that each test instance inherits from
- class OrderbookTestsFixture : public testing::TestWithParam<const char*>
+        ASSERT_EQ(sequence, expected++); 
+        ASSERT_EQ(value & 0xFFFFFFFF, nextIndex[value >> 32]++); 
+    }
+
+    for (auto& producer : producers)
+        producer.join(); 
+ }
+
+ TEST(SequencedOrderbookTests, AppliesInSequenceAndCountsPerProducer)
  { 
-    private:  
-        const static inline std::filesystem::path Root { 
-            std::filesystem::current_path()
-        };
-        const static inline std::filesystem::path TestFilesDir{ "Test_Files"}; 
-    public: 
-        const static inline std::filesystem::path TestFolderPath{ Root / "Testing" / TestFilesDir }; 
- }; 
+    std::vector<std::uint64_t> tradeSequences; 
+    SequencedOrderbook orderbook{ 2, OrderbookConfig{ }, 
+        [&](const SequencedCommand& command, const Trade&){ tradeSequences.push_back(command.sequence_); } }; 
+
+    ASSERT_EQ(orderbook.Submit(0, Command::Add(0, Order{ OrderType::GoodTillCancel, 1, Side::Sell, Price{ 100 }, 10 })), 1u); 
+    ASSERT_EQ(orderbook.Submit(1, Command::Add(0, Order{ OrderType::GoodTillCancel, 2, Side::Buy, Price{ 100 }, 4 })), 2u); 
+    ASSERT_EQ(orderbook.Submit(1, Command::Cancel(0, 2)), 3u); 
+    orderbook.Flush(); 
+
+    ASSERT_EQ(orderbook.LastApplied(), 3u); 
+    ASSERT_EQ(orderbook.Size(), 1u); 
+    ASSERT_EQ(tradeSequences, std::vector<std::uint64_t>{ 2 }); 
+
+    const auto maker = orderbook.GetProducerStats(0); 
+    const auto taker = orderbook.GetProducerStats(1); 
+    ASSERT_EQ(maker.submitted_, 1u); 
+    ASSERT_EQ(maker.applied_, 1u); 
+    ASSERT_EQ(taker.submitted_, 2u); 
+    ASSERT_EQ(taker.applied_, 1u); 
+    ASSERT_EQ(taker.rejected_, 1u); 
+    ASSERT_EQ(taker.trades_, 1u); 
+ }
 
- //Parametrized test to be used for every input instance 
- TEST_P (OrderbookTestsFixture, OrderbookTestSuite) 
+ TEST(SequencedOrderbookTests, ExpiresGoodForDayOrdersAtTheCloseUnderLoad)
  { 
-    //Arrange
-    const auto file = OrderbookTestsFixture::TestFolderPath / GetParam(); 
+    SimulatedClock clock{ TradingDayAt(15, 59) }; 
+    OrderbookConfig config; 
+    config.clock_ = &clock; 
+    SequencedOrderbook orderbook{ 1, config }; 
+
+    orderbook.Submit(0, Command::Add(0, Order{ OrderType::GoodForDay, 1, Side::Buy, Price{ 100 }, 10 })); 
+    orderbook.Submit(0, Command::Add(0, Order{ OrderType::GoodTillCancel, 2, Side::Buy, Price{ 99 }, 10 })); 
+
+    //The matcher never runs dry while the clock crosses 16:00
+    const std::size_t traffic{ 8 * MatcherLoop::PassesPerCheck }; 
+    for (std::size_t command = 0; command < traffic; ++command)
+    { 
+        if (command == traffic / 2)
+            clock.AdvanceTo(TradingDayAt(16, 1)); 
+        orderbook.Submit(0, Command::Cancel(0, 3)); 
+    }
+    orderbook.Flush(); 
+
+    ASSERT_EQ(orderbook.Size(), 1u); 
+ }
+
+ //A crash mid-write leaves a torn record, recovery keeps everything before it
+ TEST(CommandJournalTests, RecoversBookAndDropsTornTail)
+ { 
+    const auto path = std::filesystem::temp_directory_path() / "orderbook_journal_test.bin"; 
+    std::filesystem::remove(path); 
+
+    LevelInfos expectedBids, expectedAsks; 
+    { 
+        CommandJournal journal{ path }; 
+        OrderbookConfig config; 
+        config.journal_ = &journal; 
+        Orderbook orderbook{ config }; 
+
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Sell, Price{ 101 }, 10 }, TradeSink::Discard()); 
+        orderbook.AddOrder(Order{ OrderType::GoodForDay, 2, Side::Buy, Price{ 99 }, 5 }, TradeSink::Discard()); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 3, Side::Buy, Price{ 101 }, 4 }, TradeSink::Discard()); 
+        orderbook.ModifyOrder(OrderModify{ 1, Side::Sell, Price{ 102 }, 3 }, TradeSink::Discard()); 
+        orderbook.CancelOrder(42); 
+        orderbook.PruneGoodForDayOrdersNow(); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 4, Side::Buy, Price{ 98 }, 7 }, TradeSink::Discard()); 
+
+        ASSERT_EQ(orderbook.LastSequence(), 6u); 
+        journal.WaitDurable(6); 
+        expectedBids = orderbook.GetOrderInfos().GetBidInfos(); 
+        expectedAsks = orderbook.GetOrderInfos().GetAskInfos(); 
+    }
+
+    std::ofstream{ path, std::ios::binary | std::ios::app } << "torn"; 
+
+    CommandJournal journal{ path }; 
+    OrderbookConfig config; 
+    config.journal_ = &journal; 
+    Orderbook orderbook{ config }; 
+
+    ASSERT_EQ(journal.Recover(orderbook), 6u); 
+    ASSERT_EQ(orderbook.GetOrderInfos().GetBidInfos(), expectedBids); 
+    ASSERT_EQ(orderbook.GetOrderInfos().GetAskInfos(), expectedAsks); 
+
+    orderbook.CancelOrder(4); 
+    journal.WaitDurable(7); 
+    ASSERT_EQ(std::filesystem::file_size(path), 8 * sizeof(JournalRecord)); 
+    std::filesystem::remove(path); 
+ }
 
-    InputHandler handler; 
-    const auto [actions, result] = handler.GetInputInfo(file); 
+ //A book attached without recovering would number its commands from one again
+ TEST(CommandJournalTests, RejectsRecordsOutOfSequence)
+ { 
+    const auto path = std::filesystem::temp_directory_path() / "orderbook_journal_sequence_test.bin"; 
+    std::filesystem::remove(path); 
+    { 
+        CommandJournal journal{ path }; 
+        journal.Append(JournalRecord{ 5, Command::Cancel(0, 1) }); 
+        journal.Append(JournalRecord{ 6, Command::Cancel(0, 2) }); 
+        ASSERT_THROW(journal.Append(JournalRecord{ 8, Command::Cancel(0, 3) }), std::logic_error); 
+        journal.WaitDurable(6); 
+    }
+
+    CommandJournal journal{ path }; 
+    OrderbookConfig config; 
+    config.journal_ = &journal; 
+    Orderbook orderbook{ config }; 
+    ASSERT_THROW(orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Buy, Price{ 100 }, 10 }), std::logic_error); 
+    std::filesystem::remove(path); 
+ }
+
+ //Restart path: snapshot for the bulk of the day, journal for what came after it
+ TEST(SnapshotTests, SnapshotPlusJournalTailRestoresQueues)
+ { 
+    const auto directory = std::filesystem::temp_directory_path(); 
+    const auto journalPath = directory / "orderbook_restart_test.journal"; 
+    const auto snapshotPath = directory / "orderbook_restart_test.snapshot"; 
+    std::filesystem::remove(journalPath); 
 
-    //Convert text info to an order
-    auto GetOrder = [](const Action& action)
     { 
-        return std::make_shared<Order>(
-            action.orderType_, 
-            action.orderId_, 
-            action.side_,
-            action.price_, 
-            action.quantity_
-        ); 
-    };
-    
-    //Convert text info to an order modify 
-    auto GetOrderModify = [](const Action& action)
+        CommandJournal journal{ journalPath }; 
+        SnapshotWriter writer; 
+        OrderbookConfig config; 
+        config.journal_ = &journal; 
+        Orderbook orderbook{ config }; 
+
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Sell, Price{ 101 }, 10 }, TradeSink::Discard()); 
+        orderbook.AddOrder(Order{ OrderType::GoodForDay, 2, Side::Sell, Price{ 101 }, 5 }, TradeSink::Discard()); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 3, Side::Buy, Price{ 101 }, 4 }, TradeSink::Discard()); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 4, Side::Buy, Price{ 99 }, 6 }, TradeSink::Discard()); 
+        auto image = writer.SpareImage(); 
+        orderbook.CaptureSnapshot(image); 
+        writer.Write(snapshotPath, std::move(image)); 
+
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 5, Side::Sell, Price{ 101 }, 2 }, TradeSink::Discard()); 
+        orderbook.CancelOrder(4); 
+        ASSERT_EQ(writer.Wait(), 4u); 
+        ASSERT_EQ(writer.SpareImage().orders_.size(), 3u); 
+        journal.WaitDurable(orderbook.LastSequence()); 
+    }
+
+    SnapshotReader snapshot{ snapshotPath }; 
+    ASSERT_EQ(snapshot.Orders().size(), 3u); 
+    ASSERT_EQ(snapshot.Orders()[0].remainingQuantity_, 6u); 
+    ASSERT_EQ(snapshot.Orders()[1].remainingQuantity_, 6u); 
+
+    CommandJournal journal{ journalPath }; 
+    OrderbookConfig config; 
+    config.journal_ = &journal; 
+    Orderbook orderbook{ config }; 
+    orderbook.Restore(snapshot.Orders(), snapshot.LastSequence()); 
+    ASSERT_EQ(journal.Recover(orderbook), 6u); 
+    ASSERT_EQ(orderbook.Size(), 3u); 
+
+    //Queue order survived the round trip: 1 (6 left), then 2, then 5
+    Trades trades; 
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 6, Side::Buy, Price{ 101 }, 13 }, trades); 
+    ASSERT_EQ(trades.size(), 3u); 
+    ASSERT_EQ(trades[0].GetAskTrade().orderId_, 1u); 
+    ASSERT_EQ(trades[0].GetAskTrade().quantity_, 6u); 
+    ASSERT_EQ(trades[1].GetAskTrade().orderId_, 2u); 
+    ASSERT_EQ(trades[2].GetAskTrade().orderId_, 5u); 
+
+    std::filesystem::remove(journalPath); 
+    std::filesystem::remove(snapshotPath); 
+ }
+
+ //A damaged snapshot must not rest orders the id index cannot find
+ TEST(SnapshotTests, RestoreRejectsRepeatedAndReservedIds)
+ { 
+    const auto resting = [](OrderId orderId) 
     { 
-        return OrderModify {
-            action.orderId_, 
-            action.side_,
-            action.price_, 
-            action.quantity_
-        }; 
+        return SnapshotOrder{ orderId, Price{ 100 }, 10, 10, 
+            static_cast<std::uint8_t>(OrderType::GoodTillCancel), static_cast<std::uint8_t>(Side::Buy) }; 
     }; 
 
-    //Process actions
+    const std::vector<SnapshotOrder> repeated{ resting(1), resting(2), resting(1) }; 
+    ASSERT_THROW(Orderbook{ }.Restore(repeated, 3), std::logic_error); 
+
+    const std::vector<SnapshotOrder> reserved{ resting(1), resting(OrderIdIndex<OrderId>::EmptyKey) }; 
+    ASSERT_THROW(Orderbook{ }.Restore(reserved, 2), std::logic_error); 
+
     Orderbook orderbook; 
-    for (const auto& action: actions)
-    { 
-        switch(action.type_)
-        { 
-        case ActionType::Add: 
-            orderbook.AddOrder(GetOrder(action)); 
-            break; 
-        case ActionType::Modify: 
-            orderbook.ModifyOrder(GetOrderModify(action)); 
-            break; 
-        case ActionType::Cancel: 
-            orderbook.CancelOrder(action.orderId_); 
-            break; 
-        default: 
-            throw std::logic_error("Unsupported Action!"); 
-        } 
-    }  
-
-    //Compare against Result 
-    const auto& orderbookLevelInfos = orderbook.GetOrderInfos(); 
-    ASSERT_EQ(orderbook.Size(), result.allCount_); 
-    ASSERT_EQ(orderbookLevelInfos.GetBidCount(), result.bidCount_); 
-    ASSERT_EQ(orderbookLevelInfos.GetAskCount(), result.askCount_); 
+    orderbook.Restore(std::vector<SnapshotOrder>{ resting(1), resting(2) }, 2); 
+    ASSERT_EQ(orderbook.Size(), 2u); 
  }
 
- //Creates a derived fixture instance for every specified file 
- INSTANTIATE_TEST_SUITE_P(Tests, OrderbookTestsFixture, testing::ValuesIn({ 
-    "Cancel_Success.txt", 
-    "Match_FillAndKill.txt", 
-    "Match_FillOrKill_Hit.txt",
-    "Match_FillOrKill_Miss.txt", 
-    "Match_GoodTillCancel.txt",
-    "Match_Market.txt",
-    "Modify_Price.txt", 
-    "Modify_Side.txt",
-    "NoMatch_GoodTillCancel.txt"
-    })); 
-  
\ No newline at end of file
+ //Each message type lands on its symbol's book in penny ticks, sub-penny adds are skipped and a torn final message is left unconsumed
+ TEST(ItchFeedHandlerTests, BuildsBooksPerSymbolFromCapture)
+ { 
+    ItchCaptureWriter capture; 
+    capture.StockDirectory(7, "AAPL"); 
+    capture.AddOrder(7, 1, Side::Buy, 100, 1'000'000); 
+    capture.AddAttributedOrder(7, 2, Side::Buy, 50, 1'000'000, "MPID"); 
+    capture.AddOrder(9, 3, Side::Sell, 30, 1'010'000); 
+    capture.Execute(7, 1, 40, 1); 
+    capture.Cancel(7, 2, 50); 
+    capture.Replace(9, 3, 4, 25, 1'020'000); 
+    capture.Delete(9, 99); 
+    capture.AddOrder(9, 6, Side::Buy, 10, 1'000'050); 
+    const auto whole = capture.Bytes().size(); 
+    capture.AddOrder(7, 5, Side::Sell, 10, 1'030'000); 
+
+    ItchFeedHandler handler; 
+    ASSERT_EQ(handler.Process(capture.Bytes().first(whole + 10)), whole); 
+
+    const auto& stats = handler.Stats(); 
+    ASSERT_EQ(stats.messages_, 9u); 
+    ASSERT_EQ(stats.adds_, 3u); 
+    ASSERT_EQ(stats.skipped_, 1u); 
+    ASSERT_EQ(stats.unknownOrders_, 1u); 
+    ASSERT_EQ(handler.LiveOrders(), 2u); 
+    ASSERT_EQ(handler.Symbol(7), "AAPL"); 
+
+    const auto apple = handler.GetOrderbook(7)->GetOrderInfos(); 
+    ASSERT_EQ(apple.GetBidInfos(), (LevelInfos{ { Price{ 10'000 }, 60, 1 } })); 
+    ASSERT_TRUE(apple.GetAskInfos().empty()); 
+
+    const auto other = handler.GetOrderbook(9)->GetOrderInfos(); 
+    ASSERT_EQ(other.GetAskInfos(), (LevelInfos{ { Price{ 10'200 }, 25, 1 } })); 
+    ASSERT_EQ(handler.GetOrderbook(8), nullptr); 
+ }
+
+ //A crossed capture must not fill orders the handler still tracks, later executions would miss them
+ TEST(ItchFeedHandlerTests, CrossedCaptureStaysInStepWithTheFeed)
+ { 
+    ItchCaptureWriter capture; 
+    capture.AddOrder(7, 1, Side::Buy, 100, 1'010'000); 
+    capture.AddOrder(7, 2, Side::Sell, 60, 1'000'000); 
+    capture.Execute(7, 1, 30, 1); 
+
+    ItchFeedHandler handler; 
+    handler.Process(capture.Bytes()); 
+
+    ASSERT_EQ(handler.LiveOrders(), 2u); 
+    ASSERT_EQ(handler.GetOrderbook(7)->Size(), 2u); 
+    const auto book = handler.GetOrderbook(7)->GetOrderInfos(); 
+    ASSERT_EQ(book.GetBidInfos(), (LevelInfos{ { Price{ 10'100 }, 70, 1 } })); 
+    ASSERT_EQ(book.GetAskInfos(), (LevelInfos{ { Price{ 10'000 }, 60, 1 } })); 
+ }
@@ -0,0 +1,215 @@
+#include <chrono>
+#include <charconv>
+#include <format>
+#include <string>
+#include <vector>
+#include <optional>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+#include "BinaryScenario.h"
+#include "Scenario.h"
+#include "ScenarioReader.h"
+#include "WorkStealingPool.h"
+
+/*Replays scenario and captured market data files, text or binary, in
+  parallel, one fresh
+  single-writer book per file, on a work-stealing pool so a few long
+  sessions do not hold back the rest. Prints each file's outcome and
+  timings in path order, then totals, and exits non-zero if any file
+  failed its R line or could not be parsed.
+
+    replay_runner [--threads N] <directory | glob | file>...
+
+  Directories are searched recursively; a glob may use * and ? in its
+  last path component. Text files are parsed as they are replayed, so their
+  parse time is counted in the replay time*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+namespace fs = std::filesystem;
+
+struct FileReport
+{
+    fs::path path_;
+    enum class Status { Passed, Failed, Replayed, Error } status_{ Status::Error };
+    Scenario scenario_;
+    ScenarioOutcome outcome_;
+    std::string error_;
+    std::chrono::microseconds parseTime_{ };
+    std::chrono::microseconds replayTime_{ };
+};
+
+bool Matches(std::string_view pattern, std::string_view name)
+{
+    if (pattern.empty())
+        return name.empty();
+    if (pattern[0] == '*')
+        return Matches(pattern.substr(1), name) || (!name.empty() && Matches(pattern, name.substr(1)));
+    return !name.empty() && (pattern[0] == '?' || pattern[0] == name[0])
+        && Matches(pattern.substr(1), name.substr(1));
+}
+
+void Collect(const std::string& argument, std::vector<fs::path>& files)
+{
+    const fs::path path{ argument };
+
+    if (fs::is_directory(path))
+    {
+        for (const auto& entry : fs::recursive_directory_iterator{ path })
+            if (entry.is_regular_file())
+                files.push_back(entry.path());
+    }
+    else if (argument.find_first_of("*?") != std::string::npos)
+    {
+        const auto directory = path.has_parent_path() ? path.parent_path() : fs::path{ "." };
+        const auto pattern = path.filename().string();
+        for (const auto& entry : fs::directory_iterator{ directory })
+            if (entry.is_regular_file() && Matches(pattern, entry.path().filename().string()))
+                files.push_back(entry.path());
+    }
+    else if (fs::is_regular_file(path))
+        files.push_back(path);
+    else
+        std::cerr << std::format("Skipping {}: no such file or directory\n", argument);
+}
+
+void Replay(FileReport& report)
+{
+    try
+    {
+        /*A binary file is replayed straight out of its mapping, unparsed, and
+        a text file is streamed through a reader, never held whole*/
+        const auto start = SteadyClock::now();
+        std::optional<BinaryScenarioReader> binary;
+        std::optional<ScenarioReader> text;
+        if (IsBinaryScenario(report.path_))
+            binary.emplace(report.path_);
+        else
+            text.emplace(report.path_);
+        const auto parsed = SteadyClock::now();
+
+        //Only this task touches the book, which grows with what actually rests
+        OrderbookConfig config;
+        config.singleWriter_ = true;
+
+        report.outcome_ = binary ? ReplayScenario(binary->Commands(), config) : ReplayScenario(*text, config);
+        report.scenario_.expected_ = binary ? binary->Expected() : text->Expected();
+        const auto replayed = SteadyClock::now();
+
+        report.parseTime_ = std::chrono::duration_cast<std::chrono::microseconds>(parsed - start);
+        report.replayTime_ = std::chrono::duration_cast<std::chrono::microseconds>(replayed - parsed);
+
+        using Status = FileReport::Status;
+        report.status_ = !report.scenario_.expected_ ? Status::Replayed
+            : report.outcome_.Passed(report.scenario_) ? Status::Passed : Status::Failed;
+    }
+    catch (const std::exception& exception)
+    {
+        report.status_ = FileReport::Status::Error;
+        report.error_ = exception.what();
+    }
+}
+
+std::string Describe(const FileReport& report)
+{
+    using Status = FileReport::Status;
+    const auto& actual = report.outcome_.actual_;
+
+    switch (report.status_)
+    {
+    case Status::Passed:
+        return "PASS";
+    case Status::Replayed:
+        return std::format("DONE  resting {} {} {}", actual.allCount_, actual.bidCount_, actual.askCount_);
+    case Status::Failed:
+    {
+        const auto& expected = *report.scenario_.expected_;
+        return std::format("FAIL  expected {} {} {}, got {} {} {}", expected.allCount_,
+            expected.bidCount_, expected.askCount_, actual.allCount_, actual.bidCount_, actual.askCount_);
+    }
+    default:
+        return std::format("ERROR {}", report.error_);
+    }
+}
+
+int Usage()
+{
+    std::cerr << "Usage: replay_runner [--threads N] <directory | glob | file>...\n";
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t threadCount{ 0 };
+    std::vector<fs::path> files;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument{ argv[index] };
+        if (argument == "--threads")
+        {
+            const std::string_view count{ index + 1 < argc ? argv[++index] : "" };
+            const auto [end, error] = std::from_chars(count.data(), count.data() + count.size(), threadCount);
+            if (error != std::errc{ } || end != count.data() + count.size())
+            {
+                std::cerr << std::format("Bad thread count '{}'\n", count);
+                return Usage();
+            }
+        }
+        else
+            Collect(argv[index], files);
+    }
+
+    if (files.empty())
+        return Usage();
+
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    std::vector<FileReport> reports(files.size());
+    const auto start = SteadyClock::now();
+    std::size_t threadsUsed, steals;
+    {
+        WorkStealingPool pool{ threadCount };
+        for (std::size_t index = 0; index < files.size(); ++index)
+        {
+            reports[index].path_ = files[index];
+            pool.Submit([&report = reports[index]]{ Replay(report); });
+        }
+        pool.Wait();
+
+        threadsUsed = pool.ThreadCount();
+        steals = pool.Steals();
+    }
+    const auto wallTime = std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start);
+
+    std::size_t passed{ }, failed{ }, replayed{ }, errors{ }, commands{ }, trades{ };
+    std::chrono::microseconds busyTime{ };
+
+    for (const auto& report : reports)
+    {
+        using Status = FileReport::Status;
+        passed += report.status_ == Status::Passed;
+        failed += report.status_ == Status::Failed;
+        replayed += report.status_ == Status::Replayed;
+        errors += report.status_ == Status::Error;
+        commands += report.outcome_.commands_;
+        trades += report.outcome_.trades_;
+        busyTime += report.parseTime_ + report.replayTime_;
+
+        std::cout << std::format("{:>8}us parse {:>8}us replay {:>9} commands {:>8} trades  {}  {}\n",
+            report.parseTime_.count(), report.replayTime_.count(), report.outcome_.commands_, report.outcome_.trades_,
+            report.path_.string(), Describe(report));
+    }
+
+    std::cout << std::format("\n{} files: {} passed, {} failed, {} errors, {} replayed without a result\n",
+        reports.size(), passed, failed, errors, replayed);
+    std::cout << std::format("{} commands, {} trades, {}us wall, {}us busy across {} threads, {} tasks stolen\n",
+        commands, trades, wallTime.count(), busyTime.count(), threadsUsed, steals);
+
+    return failed || errors ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <string>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <filesystem>
+
+#include "BinaryScenario.h"
+#include "ScenarioReader.h"
+
+/*Converts text scenarios to the binary format and binary ones back to
+  text, telling them apart by the binary header. Streams in both
+  directions, so multi-gigabyte sessions convert in constant memory.
+
+    scenario_converter <input> <output>*/
+
+using SteadyClock = std::chrono::steady_clock;
+
+namespace fs = std::filesystem;
+
+const char* SideName(Side side)
+{
+    return side == Side::Buy ? "B" : "S";
+}
+
+const char* OrderTypeName(OrderType orderType)
+{
+    switch (orderType)
+    {
+    case OrderType::GoodTillCancel:
+        return "GoodTillCancel";
+    case OrderType::GoodForDay:
+        return "GoodForDay";
+    case OrderType::FillAndKill:
+        return "FillAndKill";
+    case OrderType::FillOrKill:
+        return "FillOrKill";
+    case OrderType::Market:
+        return "Market";
+    }
+    throw std::logic_error("Invalid order type in binary scenario");
+}
+
+//Market orders carry no price, which the text form writes as 0
+std::string FormatPrice(Price price)
+{
+    if (!price.HasValue())
+        return "0";
+
+    auto text = std::to_string(price.Units());
+    if constexpr (Price::Scale > 0)
+    {
+        const std::size_t sign = text.front() == '-';
+        const auto digits = text.size() - sign;
+        if (digits <= Price::Scale)
+            text.insert(sign, Price::Scale + 1 - digits, '0');
+        text.insert(text.size() - Price::Scale, 1, '.');
+    }
+    return text;
+}
+
+std::size_t ToText(const fs::path& input, const fs::path& output)
+{
+    const BinaryScenarioReader reader{ input };
+    std::ofstream file{ output, std::ios::binary };
+    if (!file)
+        throw std::runtime_error("Cannot create " + output.string());
+
+    for (const auto& command : reader.Commands())
+    {
+        switch (command.kind_)
+        {
+        case Command::Kind::Add:
+            file << std::format("A {} {} {} {} {}\n", SideName(command.side_), OrderTypeName(command.orderType_),
+                FormatPrice(command.price_), command.quantity_, command.orderId_);
+            break;
+        case Command::Kind::Modify:
+            file << std::format("M {} {} {} {}\n", command.orderId_, SideName(command.side_),
+                FormatPrice(command.price_), command.quantity_);
+            break;
+        case Command::Kind::Cancel:
+            file << std::format("C {}\n", command.orderId_);
+            break;
+        default:
+            throw std::logic_error("Invalid command kind in binary scenario");
+        }
+    }
+
+    if (const auto& expected = reader.Expected())
+        file << std::format("R {} {} {}\n", expected->allCount_, expected->bidCount_, expected->askCount_);
+
+    if (!file.flush())
+        throw std::runtime_error("Cannot write " + output.string());
+    return reader.Commands().size();
+}
+
+std::size_t ToBinary(const fs::path& input, const fs::path& output)
+{
+    ScenarioReader reader{ input };
+    WriteBinaryScenario(output, reader);
+    return BinaryScenarioReader{ output }.Commands().size();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: scenario_converter <input> <output>\n";
+        return 2;
+    }
+
+    try
+    {
+        const fs::path input{ argv[1] }, output{ argv[2] };
+        const bool binary = IsBinaryScenario(input);
+
+        const auto start = SteadyClock::now();
+        const auto commands = binary ? ToText(input, output) : ToBinary(input, output);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start);
+
+        std::cout << std::format("{} commands from {} {} to {} {} in {}ms\n", commands,
+            binary ? "binary" : "text", input.string(), binary ? "text" : "binary", output.string(),
+            elapsed.count());
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+}
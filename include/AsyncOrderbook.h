@@ -0,0 +1,119 @@
+#pragma once 
+
+#include <span>
+#include <mutex> 
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <coroutine>
+#include <functional>
+#include <condition_variable>
+
+#include "BookSnapshot.h"
+#include "Clock.h"
+#include "Command.h"
+#include "Orderbook.h"
+#include "OrderbookConfig.h"
+#include "Trade.h"
+
+//The outcome of one command, delivered once it has been applied
+struct ExecutionReport 
+{ 
+    Command command_{ }; 
+
+    //False if the command was rejected or found nothing to act on
+    bool applied_{ false }; 
+    Trades trades_; 
+}; 
+
+/*Asynchronous front-end to a book owned by its own executor thread. 
+  Submitting only appends to a request queue and never waits on the book, 
+  so a gateway thread can keep any number of requests in flight. Each 
+  report is delivered on the executor thread, to a callback or by resuming 
+  the coroutine that awaited Execute. The executor also expires GoodForDay 
+  orders at the close, woken by a task on the book's clock*/
+class AsyncOrderbook 
+{ 
+    public: 
+        using Callback = std::function<void(ExecutionReport&& report)>; 
+
+        //Suspends the awaiting coroutine until its command has been applied
+        class Awaitable 
+        { 
+            public: 
+                Awaitable(AsyncOrderbook& orderbook, const Command& command) 
+                    : orderbook_{ orderbook }, command_{ command } 
+                { }
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> awaiter) 
+                { 
+                    orderbook_.Submit(command_, [this, awaiter](ExecutionReport&& report)
+                    { 
+                        report_ = std::move(report); 
+                        awaiter.resume(); 
+                    }); 
+                }
+
+                ExecutionReport await_resume() { return std::move(report_); }
+
+            private: 
+                AsyncOrderbook& orderbook_; 
+                Command command_; 
+                ExecutionReport report_; 
+        }; 
+
+    private: 
+        struct Request
+        {
+            Command command_{ }; 
+            Callback callback_; 
+        }; 
+
+        Orderbook book_; 
+
+        std::mutex mutex_; 
+        std::condition_variable pendingConditionVariable_; 
+        std::vector<Request> pending_; 
+        bool shutdown_{ false }; 
+
+        /*Set by a task on the book's clock at the session close to the count 
+        of requests then queued, waking the executor to expire GoodForDay 
+        orders itself once it has applied them*/
+        std::optional<std::size_t> queuedAtClose_; 
+        Clock::TaskId closeTask_{ Clock::NoTask }; 
+
+        //Started last, once the book, queue and close wake-up exist
+        std::thread executor_; 
+
+        //Executor loop, applies requests in submission order
+        void Run(); 
+        void ApplyRequests(std::span<Request> requests); 
+
+        //Registers the wake-up at the next close, then only ever from the executor
+        void ScheduleSessionClose(); 
+
+    public: 
+
+        //Starts the executor for a book built single-writer from config
+        explicit AsyncOrderbook(const OrderbookConfig& config = OrderbookConfig{ }); 
+
+        /*Applies every request submitted before and during destruction, 
+        including those from callbacks and resumed coroutines, then stops*/
+        ~AsyncOrderbook(); 
+        AsyncOrderbook(const AsyncOrderbook&) = delete; 
+        void operator=(const AsyncOrderbook&) = delete; 
+        AsyncOrderbook(AsyncOrderbook&&) = delete; 
+        void operator=(AsyncOrderbook&&) = delete; 
+
+        //Queues command, callback later receives its report on the executor
+        void Submit(const Command& command, Callback callback); 
+
+        //co_await to submit command and resume with its report on the executor
+        Awaitable Execute(const Command& command) { return Awaitable{ *this, command }; }
+
+        //Safe from any thread, see Orderbook::GetSnapshot
+        BookSnapshot GetSnapshot() const { return book_.GetSnapshot(); }
+}; 
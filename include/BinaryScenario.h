@@ -0,0 +1,49 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <optional>
+#include <filesystem>
+#include <type_traits>
+
+#include "Command.h"
+#include "MappedFile.h"
+#include "Scenario.h"
+#include "ScenarioReader.h"
+
+static_assert(std::endian::native == std::endian::little, "Binary scenarios are little-endian and mapped in place");
+static_assert(std::is_trivially_copyable_v<Command>, "Binary scenario records are written byte for byte");
+static_assert(sizeof(Command) == 32, "Changing the command layout needs a new binary scenario version");
+
+/*A scenario in fixed-width binary: a 64 byte header carrying the command
+  count and the R line's counts, if any, then one 32 byte Command per line
+  of the text form, exactly as laid out in memory. A replay maps the file
+  and hands the records to the book as they lie, with nothing to parse*/
+
+//True if path starts with the binary scenario header rather than text
+bool IsBinaryScenario(const std::filesystem::path& path);
+
+/*Streams reader's commands into a binary scenario at path, so converting
+  never holds the whole scenario in memory. Throws std::system_error on
+  I/O failure and std::logic_error on a bad text line*/
+void WriteBinaryScenario(const std::filesystem::path& path, ScenarioReader& reader);
+
+/*Maps a binary scenario and checks its header, after which the commands
+  are read in place, trusted as the converter wrote them. Throws
+  std::logic_error for a file of another version or a truncated one*/
+class BinaryScenarioReader
+{
+    public:
+        static constexpr std::uint32_t Version{ 1 };
+
+    private:
+        MappedFile file_;
+        std::span<const Command> commands_;
+        std::optional<ScenarioResult> expected_;
+
+    public:
+        explicit BinaryScenarioReader(const std::filesystem::path& path);
+
+        std::span<const Command> Commands() const { return commands_; }
+        const std::optional<ScenarioResult>& Expected() const { return expected_; }
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Level_Info.h"
+#include "Usings.h"
+
+/*The top of an orderbook as of one event, small and trivially copyable so 
+  it can be published through a Seqlock. Only the first bidDepth_ and 
+  askDepth_ entries of each side hold levels, best price first*/
+struct BookSnapshot 
+{ 
+    static constexpr std::size_t MaxDepth{ 10 }; 
+
+    std::array<LevelInfo, MaxDepth> bids_{ }; 
+    std::array<LevelInfo, MaxDepth> asks_{ }; 
+    std::uint32_t bidDepth_{ }; 
+    std::uint32_t askDepth_{ }; 
+
+    //Resting orders in the whole book, and the events published so far
+    std::uint64_t orderCount_{ }; 
+    std::uint64_t sequence_{ }; 
+
+    //No price when the side is empty
+    Price BestBid() const { return bidDepth_ ? bids_[0].price_ : Price::None(); }
+    Price BestAsk() const { return askDepth_ ? asks_[0].price_ : Price::None(); }
+}; 
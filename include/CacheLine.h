@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+
+//Size assumed for a cache line, used to keep independently written fields apart
+inline constexpr std::size_t CacheLineSize{ 64 };
@@ -0,0 +1,141 @@
+#pragma once 
+
+#include <map>
+#include <mutex> 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "SessionScheduler.h"
+
+/*Where a book reads the time and schedules its timed events. WallClock 
+  serves production from the system clock and a SessionScheduler; 
+  SimulatedClock serves replay, where time moves only as the replayed 
+  messages say and due events fire inline*/
+class Clock 
+{ 
+    public: 
+        using TimePoint = std::chrono::system_clock::time_point; 
+        using TaskId = std::uint64_t; 
+        using Task = std::function<void()>; 
+
+        //Never returned by ScheduleAt
+        static constexpr TaskId NoTask{ 0 }; 
+
+        virtual ~Clock() = default; 
+
+        virtual TimePoint Now() const = 0; 
+
+        //Runs task once the clock reaches when
+        virtual TaskId ScheduleAt(TimePoint when, Task task) = 0; 
+
+        /*Drops a pending task, returning false if it already ran. Once it 
+        returns the task is not running, unless called from the task itself*/
+        virtual bool Cancel(TaskId taskId) = 0; 
+}; 
+
+//System time, with tasks run on a SessionScheduler's timer threads
+class WallClock : public Clock 
+{ 
+    public: 
+        explicit WallClock(SessionScheduler& scheduler = SessionScheduler::Instance()) 
+            : scheduler_{ scheduler } 
+        { }
+
+        //The clock books use unless their config names another
+        static WallClock& Instance() 
+        { 
+            static WallClock clock; 
+            return clock; 
+        }
+
+        TimePoint Now() const override { return std::chrono::system_clock::now(); }
+        TaskId ScheduleAt(TimePoint when, Task task) override { return scheduler_.ScheduleAt(when, std::move(task)); }
+        bool Cancel(TaskId taskId) override { return scheduler_.Cancel(taskId); }
+
+    private: 
+        SessionScheduler& scheduler_; 
+}; 
+
+/*Time that moves only through AdvanceTo, typically with each replayed 
+  message's timestamp. Tasks coming due fire inline on the advancing thread, 
+  in due order and each with Now() at its own due time, so a whole trading 
+  day including its close replays at CPU speed. Now may be read from any 
+  thread; scheduling, cancelling and advancing are expected from the 
+  replaying thread and the tasks it runs*/
+class SimulatedClock : public Clock 
+{ 
+    public: 
+        explicit SimulatedClock(TimePoint start = TimePoint{ }) 
+            : now_{ start } 
+        { }
+
+        TimePoint Now() const override { return now_.load(std::memory_order_acquire); }
+
+        TaskId ScheduleAt(TimePoint when, Task task) override 
+        { 
+            std::scoped_lock clockLock{ mutex_ }; 
+            const auto taskId = nextTaskId_++; 
+            tasks_.emplace(std::make_pair(when, taskId), std::move(task)); 
+            dueTimes_.emplace(taskId, when); 
+            return taskId; 
+        }
+
+        bool Cancel(TaskId taskId) override 
+        { 
+            std::scoped_lock clockLock{ mutex_ }; 
+            const auto dueTime = dueTimes_.find(taskId); 
+            if (dueTime == dueTimes_.end())
+                return false; 
+
+            tasks_.erase(std::make_pair(dueTime->second, taskId)); 
+            dueTimes_.erase(dueTime); 
+            return true; 
+        }
+
+        //Fires every task due up to when, then leaves the clock at when
+        void AdvanceTo(TimePoint when) 
+        { 
+            while (true)
+            { 
+                Task task; 
+                { 
+                    std::scoped_lock clockLock{ mutex_ }; 
+                    if (tasks_.empty() || tasks_.begin()->first.first > when)
+                        break; 
+
+                    const auto [dueTime, taskId] = tasks_.begin()->first; 
+                    task = std::move(tasks_.begin()->second); 
+                    tasks_.erase(tasks_.begin()); 
+                    dueTimes_.erase(taskId); 
+
+                    //Time never moves backwards for an overdue task
+                    if (dueTime > Now())
+                        now_.store(dueTime, std::memory_order_release); 
+                }
+
+                //Run unlocked so the task may schedule or cancel
+                task(); 
+            }
+
+            if (when > Now())
+                now_.store(when, std::memory_order_release); 
+        }
+
+        void AdvanceBy(std::chrono::nanoseconds duration) { AdvanceTo(Now() + duration); }
+
+        std::size_t Pending() const 
+        { 
+            std::scoped_lock clockLock{ mutex_ }; 
+            return tasks_.size(); 
+        }
+
+    private: 
+        std::atomic<TimePoint> now_; 
+        mutable std::mutex mutex_; 
+        std::map<std::pair<TimePoint, TaskId>, Task> tasks_; 
+        std::unordered_map<TaskId, TimePoint> dueTimes_; 
+        TaskId nextTaskId_{ NoTask + 1 }; 
+}; 
@@ -0,0 +1,52 @@
+#pragma once 
+
+#include <cstdint>
+
+#include "Order.h"
+#include "OrderModify.h"
+#include "Usings.h"
+
+/*A single instruction for the orderbook of symbolId_, flat and trivially 
+  copyable so it can be queued and handed between threads by value. Fields 
+  an instruction does not use are left at their defaults*/
+struct Command 
+{ 
+    enum class Kind : std::uint8_t 
+    { 
+        Add, 
+        Cancel, 
+        Modify 
+    }; 
+
+    Kind kind_{ Kind::Add }; 
+    OrderType orderType_{ OrderType::GoodTillCancel }; 
+    Side side_{ Side::Buy }; 
+    SymbolId symbolId_{ }; 
+    OrderId orderId_{ }; 
+    Price price_{ }; 
+    Quantity quantity_{ }; 
+
+    static Command Add(SymbolId symbolId, const Order& order) 
+    { 
+        return Command{ Kind::Add, order.GetOrderType(), order.GetSide(), symbolId, 
+            order.GetOrderId(), order.GetPrice(), order.GetInitialQuantity() }; 
+    }
+
+    static Command Cancel(SymbolId symbolId, OrderId orderId) 
+    { 
+        return Command{ Kind::Cancel, OrderType::GoodTillCancel, Side::Buy, symbolId, orderId }; 
+    }
+
+    static Command Modify(SymbolId symbolId, const OrderModify& modify) 
+    { 
+        return Command{ Kind::Modify, OrderType::GoodTillCancel, modify.GetSide(), symbolId, 
+            modify.GetOrderId(), modify.GetPrice(), modify.GetQuantity() }; 
+    }
+
+    bool operator==(const Command&) const = default; 
+
+    //Prices pass through as given, an unprotected Market command carries Price::None()
+    Order ToOrder() const { return Order{ orderType_, orderId_, side_, price_, quantity_ }; }
+
+    OrderModify ToOrderModify() const { return OrderModify{ orderId_, side_, price_, quantity_ }; }
+}; 
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <condition_variable>
+
+#include "JournalRecord.h"
+
+class Orderbook;
+
+/*Append-only write-ahead journal of the commands that changed one book.
+  Append only queues a record in memory; a background thread writes
+  everything queued since its last pass in one batch and makes it durable
+  with a single fsync, so the matcher never waits on the disk and one sync
+  covers as many records as arrived while the previous one ran.
+
+  The file is a header followed by fixed-width JournalRecords with
+  consecutive sequence numbers. Opening an existing journal keeps the
+  longest valid prefix and cuts off a record torn by a crash, so appends
+  continue where the last durable record left off*/
+class CommandJournal
+{
+    public:
+        static constexpr std::uint32_t Version{ 1 };
+
+    private:
+        int fd_{ -1 };
+        std::filesystem::path path_;
+
+        //Valid records found on opening, the ones Recover replays
+        std::uint64_t recordsAtOpen_{ 0 };
+
+        mutable std::mutex mutex_;
+        std::condition_variable pendingConditionVariable_;
+        mutable std::condition_variable durableConditionVariable_;
+        std::vector<JournalRecord> pending_;
+        bool shutdown_{ false };
+
+        //Sequence of the last record found on opening or appended, zero for none
+        std::uint64_t lastAppended_{ 0 };
+        int error_{ 0 };
+
+        std::atomic<std::uint64_t> durable_{ 0 };
+        std::atomic<std::uint64_t> batches_{ 0 };
+
+        //Declared last so it starts only once everything it uses exists
+        std::thread thread_;
+
+        //Group commit loop run by the writer thread
+        void Run();
+
+        //Validates the header and records, trimming anything after the last good record
+        void Open();
+
+    public:
+
+        //Creates the journal if missing, throws std::system_error on I/O failure
+        explicit CommandJournal(const std::filesystem::path& path);
+
+        //Writes and syncs every record appended before destruction
+        ~CommandJournal();
+        CommandJournal(const CommandJournal&) = delete;
+        void operator=(const CommandJournal&) = delete;
+        CommandJournal(CommandJournal&&) = delete;
+        void operator=(CommandJournal&&) = delete;
+
+        /*Queues record for the writer thread, never touches the disk. Throws
+        std::logic_error unless record follows the journal's last one, as when
+        a book is attached to a journal it was not recovered from*/
+        void Append(const JournalRecord& record);
+
+        /*Blocks until the record with sequence has been synced, throwing
+        std::system_error if the writer has failed*/
+        void WaitDurable(std::uint64_t sequence) const;
+
+        //Sequence number of the last synced record, including those found on opening
+        std::uint64_t Durable() const { return durable_.load(std::memory_order_acquire); }
+
+        //Group commits so far, each one write and one fsync
+        std::uint64_t Batches() const { return batches_.load(std::memory_order_relaxed); }
+
+        /*Replays the records found on opening into book, which should be
+        freshly built with this journal in its config, and returns the
+        last sequence number replayed. Records the book already has, such
+        as those covered by a snapshot it was loaded from, are skipped*/
+        std::uint64_t Recover(Orderbook& book) const;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+/*Binary indexed tree over a fixed number of slots, giving O(log n) point
+  updates and prefix sums*/
+class FenwickTree
+{
+public:
+    explicit FenwickTree(std::size_t size) : tree_(size + 1) { }
+
+    void Add(std::size_t index, std::int64_t delta)
+    {
+        for (++index; index < tree_.size(); index += index & (~index + 1))
+            tree_[index] += delta;
+    }
+
+    //Sum of slots [0, count)
+    std::int64_t PrefixSum(std::size_t count) const
+    {
+        std::int64_t sum{ };
+        for (; count; count -= count & (~count + 1))
+            sum += tree_[count];
+        return sum;
+    }
+
+private:
+    std::vector<std::int64_t> tree_;
+};
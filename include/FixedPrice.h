@@ -0,0 +1,97 @@
+#pragma once
+
+#include <limits>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <string_view>
+
+/*A price held as an integer count of units of 10^-DecimalScale, quoted on a
+  grid of TickSize units. "No price", as carried by market orders, is the
+  smallest representable value, so it orders below every real price exactly
+  as an empty std::optional did and every comparison is one integer compare.
+  Rep is std::int32_t for most instruments, std::int64_t when prices need
+  more headroom*/
+template <typename Rep, Rep TickSize, unsigned DecimalScale>
+class FixedPrice
+{
+    static_assert(std::is_signed_v<Rep>, "FixedPrice needs a signed representation");
+    static_assert(TickSize > 0, "Tick size must be positive");
+
+public:
+    using Representation = Rep;
+
+    static constexpr Rep Tick{ TickSize };
+    static constexpr unsigned Scale{ DecimalScale };
+
+    //Defaults to no price
+    constexpr FixedPrice() = default;
+    constexpr explicit FixedPrice(Rep units) : units_{ units } { }
+
+    static constexpr FixedPrice None() { return FixedPrice{ }; }
+    static constexpr FixedPrice FromTicks(Rep ticks) { return FixedPrice{ ticks * TickSize }; }
+
+    constexpr bool HasValue() const { return units_ != NoneUnits; }
+    constexpr Rep Units() const { return units_; }
+    constexpr Rep Ticks() const { return units_ / TickSize; }
+    constexpr bool IsOnTick() const { return units_ % TickSize == 0; }
+
+    constexpr auto operator<=>(const FixedPrice&) const = default;
+
+    /*Parses a decimal such as "101" or "-101.25" with at most DecimalScale
+    fractional digits, returning nothing if text is malformed or out of range*/
+    static constexpr std::optional<FixedPrice> FromString(std::string_view text)
+    {
+        const bool negative = !text.empty() && text.front() == '-';
+        if (negative)
+            text.remove_prefix(1);
+
+        const auto point = text.find('.');
+        const auto whole = text.substr(0, point);
+        const auto fraction = point == std::string_view::npos ? std::string_view{ } : text.substr(point + 1);
+
+        if (whole.empty() || fraction.size() > DecimalScale
+            || (point != std::string_view::npos && fraction.empty()))
+            return std::nullopt;
+
+        Rep units{ };
+        auto AppendDigit = [&units](char digit)
+        {
+            if (digit < '0' || digit > '9')
+                return false;
+
+            const Rep value = digit - '0';
+            if (units > (std::numeric_limits<Rep>::max() - value) / 10)
+                return false;
+
+            units = units * 10 + value;
+            return true;
+        };
+
+        for (char digit : whole)
+            if (!AppendDigit(digit))
+                return std::nullopt;
+
+        for (unsigned place = 0; place < DecimalScale; ++place)
+            if (!AppendDigit(place < fraction.size() ? fraction[place] : '0'))
+                return std::nullopt;
+
+        return FixedPrice{ negative ? -units : units };
+    }
+
+private:
+    static constexpr Rep NoneUnits{ std::numeric_limits<Rep>::min() };
+
+    Rep units_{ NoneUnits };
+};
+
+template <typename Rep, Rep TickSize, unsigned DecimalScale>
+struct std::hash<FixedPrice<Rep, TickSize, DecimalScale>>
+{
+    std::size_t operator()(const FixedPrice<Rep, TickSize, DecimalScale>& price) const noexcept
+    {
+        return std::hash<Rep>{ }(price.Units());
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "Command.h"
+#include "OrderIdIndex.h"
+#include "Orderbook.h"
+#include "OrderbookConfig.h"
+#include "Usings.h"
+
+/*Counts of what a feed handler has decoded. Orders it never saw added,
+  as when a capture starts mid-session, are counted and otherwise ignored*/
+struct ItchFeedStats
+{
+    std::uint64_t messages_{ };
+    std::uint64_t adds_{ };
+    std::uint64_t executions_{ };
+    std::uint64_t cancels_{ };
+    std::uint64_t deletes_{ };
+    std::uint64_t replaces_{ };
+    std::uint64_t skipped_{ };
+    std::uint64_t unknownOrders_{ };
+};
+
+/*Builds a capture in the framing ItchFeedHandler reads: each message
+  prefixed by its big-endian two byte length, fields big-endian and laid
+  out as in ITCH 5.0. Timestamps and tracking numbers are left zero.
+  Prices are in the feed's units of 1/10000*/
+class ItchCaptureWriter
+{
+    private:
+        std::vector<std::byte> bytes_;
+
+        //Appends a zeroed message of length bytes and returns its start
+        std::byte* Append(char type, std::uint16_t locate, std::size_t length);
+
+    public:
+        void StockDirectory(std::uint16_t locate, std::string_view symbol);
+        void AddOrder(std::uint16_t locate, std::uint64_t orderRef, Side side, std::uint32_t shares, std::uint32_t price);
+        void AddAttributedOrder(std::uint16_t locate, std::uint64_t orderRef, Side side, std::uint32_t shares,
+            std::uint32_t price, std::string_view attribution);
+        void Execute(std::uint16_t locate, std::uint64_t orderRef, std::uint32_t shares, std::uint64_t matchNumber);
+        void Cancel(std::uint16_t locate, std::uint64_t orderRef, std::uint32_t shares);
+        void Delete(std::uint16_t locate, std::uint64_t orderRef);
+        void Replace(std::uint16_t locate, std::uint64_t orderRef, std::uint64_t newOrderRef,
+            std::uint32_t shares, std::uint32_t price);
+
+        std::span<const std::byte> Bytes() const { return bytes_; }
+};
+
+/*Builds market-by-order books from an ITCH 5.0-like capture, one
+  single-writer mirror Orderbook per stock locate, created on first use.
+  Mirror books never match, so each stays in step with the handler's
+  table of live orders even if a capture crosses it. Adds (A, F) rest as
+  GoodTillCancel orders priced in book ticks; executions and partial
+  cancels (E, X) reduce an order in place, keeping its time priority;
+  deletes (D) cancel it and replaces (U) cancel it and add the new
+  reference behind the level. Other message types are skipped by their
+  length, apart from stock directory (R) messages, which name the locate.
+  The handler keeps each live order's side, price and size, as E, X and D
+  messages carry only the reference. Messages are decoded a chunk at a
+  time into per-book batches, so each book publishes one snapshot per
+  chunk rather than per message*/
+class ItchFeedHandler
+{
+    private:
+        struct FeedOrder
+        {
+            Side side_{ };
+            Price price_{ };
+            Quantity quantity_{ };
+        };
+
+        struct Book
+        {
+            std::unique_ptr<Orderbook> orderbook_;
+            std::array<char, 8> symbol_{ };
+            std::vector<Command> pending_;
+        };
+
+        OrderbookConfig bookConfig_;
+        std::uint32_t priceUnitsPerTick_;
+        std::vector<Book> books_;
+        std::vector<std::uint16_t> pendingLocates_;
+        OrderIdIndex<FeedOrder> orders_;
+        ItchFeedStats stats_;
+
+        Book& BookFor(std::uint16_t locate);
+        void Queue(std::uint16_t locate, const Command& command);
+        Price ToPrice(std::uint32_t feedPrice) const;
+        void Decode(std::span<const std::byte> message);
+        void Reduce(std::uint16_t locate, OrderId orderRef, Quantity shares);
+        void FlushPending();
+
+    public:
+        /*Messages decoded before the pending batches are applied. Large
+        chunks give each book a long batch, applied while its levels and
+        orders are still in cache*/
+        static constexpr std::size_t ChunkSize{ 1 << 16 };
+
+        /*Every book is created from bookConfig with singleWriter_ and
+        mirror_ set. Feed prices are in units of 1/10000 and books quote in
+        ticks of priceUnitsPerTick of them, a cent by default as stocks from
+        $1 up are quoted. Adds priced off that grid are skipped; give 1 to
+        keep sub-penny prices. ITCH order references are unique across symbols,
+        so expectedOrders sizes the handler's one table of live orders*/
+        explicit ItchFeedHandler(const OrderbookConfig& bookConfig = OrderbookConfig{ },
+            std::uint32_t priceUnitsPerTick = 100, std::size_t expectedOrders = 1 << 20);
+
+        /*Decodes and applies every whole message in capture and returns the
+        bytes consumed, short of a message torn off at the end. Throws
+        std::logic_error for a message too short for its type*/
+        std::size_t Process(std::span<const std::byte> capture);
+
+        //Maps path and processes it whole
+        std::size_t ProcessFile(const std::filesystem::path& path);
+
+        const ItchFeedStats& Stats() const { return stats_; }
+        std::size_t LiveOrders() const { return orders_.Size(); }
+
+        //The book for locate, or nullptr if no message has created it
+        const Orderbook* GetOrderbook(std::uint16_t locate) const;
+
+        //The name given by locate's stock directory message, if any, unpadded
+        std::string_view Symbol(std::uint16_t locate) const;
+};
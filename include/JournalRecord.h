@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Command.h"
+
+/*One command as journalled, with the sequence number the book gave it.
+  Records are written and mapped back exactly as laid out here, so the
+  journal is only readable on a machine of the same endianness*/
+struct JournalRecord
+{
+    std::uint64_t sequence_{ };
+    Command command_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<JournalRecord>, "Journal records are written byte for byte");
+static_assert(sizeof(JournalRecord) == 40, "Changing the record layout needs a new journal version");
@@ -9,6 +9,8 @@ struct LevelInfo
     Price price_; 
     Quantity quantity_; 
     Quantity orderCount_; 
+
+    bool operator==(const LevelInfo&) const = default; 
 }; 
 
 using LevelInfos = std::vector<LevelInfo>; 
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+#include <filesystem>
+
+/*Maps a whole file read-only for as long as the object lives, so readers
+  parse it in place without copying it into memory first. An empty file
+  maps to an empty span. Throws std::system_error if the file cannot be
+  opened or mapped*/
+class MappedFile
+{
+    private:
+        const std::byte* data_{ nullptr };
+        std::size_t size_{ 0 };
+
+    public:
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        void operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        void operator=(MappedFile&&) = delete;
+
+        std::span<const std::byte> Bytes() const { return { data_, size_ }; }
+        std::size_t Size() const { return size_; }
+};
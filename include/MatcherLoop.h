@@ -0,0 +1,60 @@
+#pragma once 
+
+#include <thread>
+#include <cstddef>
+
+#include "Clock.h"
+#include "Orderbook.h"
+
+/*Paces the loop of a thread that owns a single-writer book, as 
+  OrderbookEngine and SequencedOrderbook do. The owner calls EndPass once 
+  per pass, busy or not. Every PassesPerCheck passes it reads the book's 
+  clock and, once the session close is reached, expires the book's 
+  GoodForDay orders, so a loop that never runs dry still expires them. 
+  After IdlePassesBeforeYield empty passes in a row it yields the core*/
+class MatcherLoop 
+{ 
+    public: 
+        static constexpr std::size_t PassesPerCheck{ 1024 }; 
+        static constexpr std::size_t IdlePassesBeforeYield{ 1024 }; 
+
+    private: 
+        Orderbook& book_; 
+        Clock::TimePoint sessionClose_; 
+        std::size_t passes_{ }; 
+        std::size_t idlePasses_{ }; 
+
+    public: 
+        explicit MatcherLoop(Orderbook& book) 
+            : book_{ book }, sessionClose_{ Orderbook::NextSessionClose(book.GetClock().Now()) } 
+        { }
+
+        //Expires GoodForDay orders if the close has come since the last check
+        void CheckSessionClose() 
+        { 
+            passes_ = 0; 
+            if (const auto now = book_.GetClock().Now(); now >= sessionClose_)
+            { 
+                book_.PruneGoodForDayOrdersNow(); 
+                sessionClose_ = Orderbook::NextSessionClose(now); 
+            }
+        }
+
+        //worked is whether the pass found anything to apply
+        void EndPass(bool worked) 
+        { 
+            if (++passes_ == PassesPerCheck)
+                CheckSessionClose(); 
+
+            if (worked)
+            { 
+                idlePasses_ = 0; 
+                return; 
+            }
+            if (++idlePasses_ < IdlePassesBeforeYield)
+                return; 
+
+            idlePasses_ = 0; 
+            std::this_thread::yield(); 
+        }
+}; 
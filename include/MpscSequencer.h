@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+
+#include "CacheLine.h"
+
+/*Bounded lock-free queue for any number of producer threads and one
+  consumer that also orders them. A producer claims the next global
+  sequence number with a single fetch_add, which decides its place in the
+  stream, and writes into that number's slot; the consumer takes slots
+  strictly in sequence order. A producer only ever waits when the ring is
+  full, and the consumer waits on a claimed slot until its producer has
+  finished writing it. Sequence numbers start at one*/
+template <typename T, std::size_t Capacity>
+class MpscSequencer
+{
+    static_assert(Capacity > 1 && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+    MpscSequencer()
+    {
+        for (std::size_t index = 0; index < Capacity; ++index)
+            slots_[index].turn_.store(index, std::memory_order_relaxed);
+    }
+
+    MpscSequencer(const MpscSequencer&) = delete;
+    void operator=(const MpscSequencer&) = delete;
+
+    /*Any thread. Returns the sequence number value was given, stalled is
+    set when the ring was full and the call had to wait for room*/
+    std::uint64_t Publish(const T& value, bool& stalled)
+    {
+        const auto ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = slots_[ticket & Mask];
+
+        stalled = false;
+        while (slot.turn_.load(std::memory_order_acquire) != ticket)
+        {
+            stalled = true;
+            std::this_thread::yield();
+        }
+
+        slot.value_ = value;
+        slot.turn_.store(ticket + 1, std::memory_order_release);
+        return ticket + 1;
+    }
+
+    //Consumer only, false until the next sequence number has been written
+    bool TryConsume(T& value, std::uint64_t& sequence)
+    {
+        auto& slot = slots_[head_ & Mask];
+        if (slot.turn_.load(std::memory_order_acquire) != head_ + 1)
+            return false;
+
+        value = slot.value_;
+        sequence = ++head_;
+        slot.turn_.store(head_ - 1 + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    //Highest sequence number claimed so far, its value may not be written yet
+    std::uint64_t LastClaimed() const { return next_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t Mask{ Capacity - 1 };
+
+    /*turn_ is the ticket the slot waits for while free, and that ticket
+    plus one once its value is written*/
+    struct alignas(CacheLineSize) Slot
+    {
+        std::atomic<std::uint64_t> turn_{ };
+        T value_{ };
+    };
+
+    alignas(CacheLineSize) std::atomic<std::uint64_t> next_{ 0 };
+    alignas(CacheLineSize) std::uint64_t head_{ 0 };
+    std::array<Slot, Capacity> slots_;
+};
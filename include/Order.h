@@ -1,6 +1,7 @@
 #pragma once
 
-#include <list>
+#include <memory>
+#include <limits>
 #include <exception>
 #include <format>
 
@@ -8,6 +9,9 @@
 #include "Side.h"
 #include "Usings.h"
 
+//Marks the end of an intrusive order queue
+inline constexpr OrderIndex InvalidOrderIndex{ std::numeric_limits<OrderIndex>::max() }; 
+
 class Order 
 {
 public: 
@@ -17,8 +21,10 @@ public:
             remainingQuantity_{ quantity }
     { }
 
+    /*A market order. When given through the full constructor instead, its 
+    price is a protection limit the sweep will not trade beyond*/
     Order(OrderId orderId, Side side, Quantity quantity) 
-        : Order(OrderType::Market, orderId, side, std::nullopt, quantity)
+        : Order(OrderType::Market, orderId, side, Price::None(), quantity)
         { }
 
     OrderId GetOrderId() const { return orderId_; }
@@ -43,18 +49,40 @@ public:
         remainingQuantity_ -= quantity; 
     }
 
-    void ToGoodTillCancel(Price price) 
+    //Lowers the order's size without touching its place in the queue
+    void ReduceQuantity(Quantity quantity) 
     { 
-        if (GetOrderType() != OrderType::Market)
+        if (quantity > GetRemainingQuantity()) 
             throw std::logic_error(std::format(
-                "Order {} is not a market order. Cannot modify price and type.", 
-                GetOrderId())
+                "Order {} cannot be reduced by more than its remaining quantity {}", 
+                GetOrderId(), 
+                GetRemainingQuantity())
             ); 
-        
+        initialQuantity_ -= quantity; 
+        remainingQuantity_ -= quantity; 
+    }
+
+    //Requotes the order as if newly entered with side, price and quantity
+    void Amend(Side side, Price price, Quantity quantity) 
+    { 
+        side_ = side; 
         price_ = price; 
-        orderType_ = OrderType::GoodTillCancel; 
+        initialQuantity_ = quantity; 
+        remainingQuantity_ = quantity; 
     }
 
+    /*Intrusive links to the neighbouring orders of the same price level,
+    stored as indices into the orderbook's OrderPool*/
+    OrderIndex GetPrevious() const { return previous_; }
+    OrderIndex GetNext() const { return next_; }
+    void SetPrevious(OrderIndex previous) { previous_ = previous; }
+    void SetNext(OrderIndex next) { next_ = next; }
+
+    //Intrusive links to neighbouring GoodForDay orders in the book's expiry list
+    OrderIndex GetExpiryPrevious() const { return expiryPrevious_; }
+    OrderIndex GetExpiryNext() const { return expiryNext_; }
+    void SetExpiryPrevious(OrderIndex previous) { expiryPrevious_ = previous; }
+    void SetExpiryNext(OrderIndex next) { expiryNext_ = next; }
 
 private: 
     OrderType orderType_; 
@@ -63,9 +91,11 @@ private:
     Price price_; 
     Quantity initialQuantity_; 
     Quantity remainingQuantity_;  
+    OrderIndex previous_{ InvalidOrderIndex }; 
+    OrderIndex next_{ InvalidOrderIndex }; 
+    OrderIndex expiryPrevious_{ InvalidOrderIndex }; 
+    OrderIndex expiryNext_{ InvalidOrderIndex }; 
 }; 
 
 using OrderPointer = std::shared_ptr<Order>; 
-//List allows dispersed memory storage 
-using OrderPointers = std::list<OrderPointer>;  
 
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <limits>
+#include <optional>
+#include <cstdint>
+
+#include "Usings.h"
+
+/*Flat map from OrderId to Value. In Hashed mode it is an open-addressing
+  table with linear probing and backward-shift deletion, so erasing leaves no
+  tombstones behind. In Dense mode, meant for venues that assign ids
+  sequentially, an id maps straight to slot id % capacity with no probing;
+  the ring doubles whenever a new id lands on a slot still held by an older
+  live id, so its size tracks the span of live ids*/
+template <typename Value>
+class OrderIdIndex
+{
+public:
+    enum class Mode
+    {
+        Hashed,
+        Dense
+    };
+
+    //Reserved to mark empty slots, never accepted as a key
+    static constexpr OrderId EmptyKey{ std::numeric_limits<OrderId>::max() };
+
+    explicit OrderIdIndex(Mode mode = Mode::Hashed, std::size_t expectedSize = 1024)
+        : mode_{ mode }
+    {
+        Rehash(CapacityFor(expectedSize));
+    }
+
+    std::size_t Size() const { return size_; }
+    bool Empty() const { return !size_; }
+    bool Contains(OrderId orderId) const { return Find(orderId) != nullptr; }
+
+    //Returns the value stored for orderId, or nullptr if it is absent
+    Value* Find(OrderId orderId)
+    {
+        return const_cast<Value*>(static_cast<const OrderIdIndex&>(*this).Find(orderId));
+    }
+
+    const Value* Find(OrderId orderId) const
+    {
+        const auto slot = FindSlot(orderId);
+        return slot == NotFound ? nullptr : &slots_[slot].value_;
+    }
+
+    //Inserts value for orderId, returning false if orderId is already present
+    bool Insert(OrderId orderId, const Value& value)
+    {
+        if (orderId == EmptyKey)
+            return false;
+
+        if (mode_ == Mode::Dense)
+        {
+            if (slots_[HomeOf(orderId)].key_ == orderId)
+                return false;
+            while (slots_[HomeOf(orderId)].key_ != EmptyKey)
+                Rehash(slots_.size() * 2);
+        }
+        else if ((size_ + 1) * 4 > slots_.size() * 3)
+            Rehash(slots_.size() * 2);
+
+        //One probe run both rejects duplicates and finds the free slot
+        auto slot = HomeOf(orderId);
+        for (; slots_[slot].key_ != EmptyKey; slot = (slot + 1) & mask_)
+            if (slots_[slot].key_ == orderId)
+                return false;
+
+        slots_[slot].key_ = orderId;
+        slots_[slot].value_ = value;
+        ++size_;
+        return true;
+    }
+
+    bool Erase(OrderId orderId) { return Extract(orderId).has_value(); }
+
+    //Removes orderId and returns its value with a single probe sequence
+    std::optional<Value> Extract(OrderId orderId)
+    {
+        const auto slot = FindSlot(orderId);
+        if (slot == NotFound)
+            return std::nullopt;
+
+        auto value = std::move(slots_[slot].value_);
+        if (mode_ == Mode::Hashed)
+            ShiftBackward(slot);
+        else
+            slots_[slot].key_ = EmptyKey;
+
+        --size_;
+        return value;
+    }
+
+    //Visits every key and value in slot order
+    template <typename Visitor>
+    void ForEach(Visitor visitor) const
+    {
+        for (const auto& slot : slots_)
+            if (slot.key_ != EmptyKey)
+                visitor(slot.key_, slot.value_);
+    }
+
+    /*Grows ahead of a bulk load of count ids from lowest to highest, so 
+    none of their inserts rehashes. Dense mode needs a slot per id in the span*/
+    void Reserve(std::size_t count, OrderId lowest, OrderId highest)
+    {
+        if (!count)
+            return;
+
+        const auto capacity = mode_ == Mode::Dense 
+            ? std::bit_ceil(static_cast<std::size_t>(highest - lowest) + 1) : CapacityFor(size_ + count);
+        if (capacity > slots_.size())
+            Rehash(capacity);
+    }
+
+    void Clear()
+    {
+        for (auto& slot : slots_)
+            slot.key_ = EmptyKey;
+        size_ = 0;
+    }
+
+private:
+    struct Slot
+    {
+        OrderId key_{ EmptyKey };
+        Value value_{ };
+    };
+
+    static constexpr std::size_t NotFound{ std::numeric_limits<std::size_t>::max() };
+
+    static std::size_t CapacityFor(std::size_t size)
+    {
+        std::size_t capacity{ 16 };
+        while (capacity * 3 < size * 4)
+            capacity *= 2;
+        return capacity;
+    }
+
+    //Fibonacci hashing spreads clustered ids across the table
+    std::size_t HomeOf(OrderId orderId) const
+    {
+        if (mode_ == Mode::Dense)
+            return static_cast<std::size_t>(orderId) & mask_;
+        return static_cast<std::size_t>((orderId * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    std::size_t FindSlot(OrderId orderId) const
+    {
+        auto slot = HomeOf(orderId);
+        if (mode_ == Mode::Dense)
+            return slots_[slot].key_ == orderId && orderId != EmptyKey ? slot : NotFound;
+
+        while (true)
+        {
+            const auto key = slots_[slot].key_;
+            if (key == orderId && key != EmptyKey)
+                return slot;
+            if (key == EmptyKey)
+                return NotFound;
+            slot = (slot + 1) & mask_;
+        }
+    }
+
+    void Place(OrderId orderId, const Value& value)
+    {
+        auto slot = HomeOf(orderId);
+        while (slots_[slot].key_ != EmptyKey)
+            slot = (slot + 1) & mask_;
+
+        slots_[slot].key_ = orderId;
+        slots_[slot].value_ = value;
+    }
+
+    /*Closes the gap at hole by pulling back later entries of the probe run
+    whose home slot does not lie between the hole and their own slot*/
+    void ShiftBackward(std::size_t hole)
+    {
+        auto slot = (hole + 1) & mask_;
+        while (slots_[slot].key_ != EmptyKey)
+        {
+            const auto home = HomeOf(slots_[slot].key_);
+            if (((slot - home) & mask_) >= ((slot - hole) & mask_))
+            {
+                slots_[hole] = std::move(slots_[slot]);
+                hole = slot;
+            }
+            slot = (slot + 1) & mask_;
+        }
+        slots_[hole].key_ = EmptyKey;
+    }
+
+    //In Dense mode keeps doubling until every live id has a slot of its own
+    void Rehash(std::size_t capacity)
+    {
+        std::vector<Slot> previous;
+        previous.swap(slots_);
+
+        while (true)
+        {
+            slots_.assign(capacity, Slot{ });
+            mask_ = capacity - 1;
+            shift_ = 64;
+            for (auto bits = capacity; bits > 1; bits >>= 1)
+                --shift_;
+
+            bool placed{ true };
+            for (const auto& slot : previous)
+            {
+                if (slot.key_ == EmptyKey)
+                    continue;
+
+                if (mode_ == Mode::Dense && slots_[HomeOf(slot.key_)].key_ != EmptyKey)
+                {
+                    placed = false;
+                    break;
+                }
+                Place(slot.key_, slot.value_);
+            }
+
+            if (placed)
+                return;
+            capacity *= 2;
+        }
+    }
+
+    Mode mode_;
+    std::vector<Slot> slots_;
+    std::size_t size_{ };
+    std::size_t mask_{ };
+    unsigned shift_{ };
+};
@@ -16,11 +16,14 @@ public:
     Side GetSide() const { return side_; }
     Quantity GetQuantity() const {return quantity_;}
     
+    Order ToOrder(OrderType type) const 
+    { 
+        return Order{ type, GetOrderId(), GetSide(), GetPrice(), GetQuantity() }; 
+    }
+
     OrderPointer ToOrderPointer(OrderType type) const 
     { 
-        return std::make_shared<Order>(type, GetOrderId(), 
-                                        GetSide(), GetPrice(),
-                                        GetQuantity()); 
+        return std::make_shared<Order>(ToOrder(type)); 
     }
 
 private: 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Order.h"
+#include "Usings.h"
+
+/*Owns the orderbook's resting orders by value. Each order occupies a slot
+  addressed by an OrderIndex, which price levels use as intrusive queue links.
+  Filled and cancelled orders hand their slot back to a free list for reuse,
+  so steady-state trading performs no allocation and no reference counting.
+  Indices are plain and unchecked: the book drops an order's id entry and
+  queue links as it releases the slot, so nothing is left holding it*/
+class OrderPool
+{
+public:
+    static constexpr std::size_t DefaultCapacity{ 1 << 16 };
+
+    explicit OrderPool(std::size_t capacity = DefaultCapacity)
+    {
+        slots_.reserve(capacity);
+        freeSlots_.reserve(capacity);
+    }
+
+    OrderIndex Acquire(const Order& order)
+    {
+        if (freeSlots_.empty())
+        {
+            slots_.push_back(order);
+            return static_cast<OrderIndex>(slots_.size() - 1);
+        }
+
+        const auto index = freeSlots_.back();
+        freeSlots_.pop_back();
+        slots_[index] = order;
+        return index;
+    }
+
+    //Makes room for count more orders ahead of a bulk load
+    void Reserve(std::size_t count)
+    {
+        if (count > freeSlots_.size())
+            slots_.reserve(slots_.size() + count - freeSlots_.size());
+    }
+
+    //Returns the slot for reuse by the next Acquire
+    void Release(OrderIndex index) { freeSlots_.push_back(index); }
+
+    Order& operator[](OrderIndex index) { return slots_[index]; }
+    const Order& operator[](OrderIndex index) const { return slots_[index]; }
+
+private:
+    std::vector<Order> slots_;
+    std::vector<OrderIndex> freeSlots_;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "OrderPool.h"
+
+//Links an order's place in its price level
+struct LevelLinks
+{
+    static OrderIndex Previous(const Order& order) { return order.GetPrevious(); }
+    static OrderIndex Next(const Order& order) { return order.GetNext(); }
+    static void SetPrevious(Order& order, OrderIndex previous) { order.SetPrevious(previous); }
+    static void SetNext(Order& order, OrderIndex next) { order.SetNext(next); }
+};
+
+//Links a GoodForDay order's place in the book's expiry list
+struct ExpiryLinks
+{
+    static OrderIndex Previous(const Order& order) { return order.GetExpiryPrevious(); }
+    static OrderIndex Next(const Order& order) { return order.GetExpiryNext(); }
+    static void SetPrevious(Order& order, OrderIndex previous) { order.SetExpiryPrevious(previous); }
+    static void SetNext(Order& order, OrderIndex next) { order.SetExpiryNext(next); }
+};
+
+/*FIFO of pooled orders. Orders are linked through their own previous/next
+  pool indices, chosen by Links, so the list is just a head and a tail and
+  pushing, popping or unlinking any order is O(1) with no allocation. An
+  order can be on one list per kind of link at once*/
+template <typename Links>
+class IntrusiveOrderList
+{
+public:
+    bool Empty() const { return head_ == InvalidOrderIndex; }
+    OrderIndex Front() const { return head_; }
+
+    void PushBack(OrderPool& pool, OrderIndex index)
+    {
+        auto& order = pool[index];
+        Links::SetPrevious(order, tail_);
+        Links::SetNext(order, InvalidOrderIndex);
+
+        if (Empty())
+            head_ = index;
+        else
+            Links::SetNext(pool[tail_], index);
+
+        tail_ = index;
+    }
+
+    void Erase(OrderPool& pool, OrderIndex index)
+    {
+        auto& order = pool[index];
+        const auto previous = Links::Previous(order);
+        const auto next = Links::Next(order);
+
+        if (previous == InvalidOrderIndex)
+            head_ = next;
+        else
+            Links::SetNext(pool[previous], next);
+
+        if (next == InvalidOrderIndex)
+            tail_ = previous;
+        else
+            Links::SetPrevious(pool[next], previous);
+
+        Links::SetPrevious(order, InvalidOrderIndex);
+        Links::SetNext(order, InvalidOrderIndex);
+    }
+
+    void PopFront(OrderPool& pool) { Erase(pool, head_); }
+
+    //Visits orders from the front of the list to the back
+    template <typename Visitor>
+    void ForEach(const OrderPool& pool, Visitor visitor) const
+    {
+        for (auto index = head_; index != InvalidOrderIndex; index = Links::Next(pool[index]))
+            visitor(pool[index]);
+    }
+
+private:
+    OrderIndex head_{ InvalidOrderIndex };
+    OrderIndex tail_{ InvalidOrderIndex };
+};
+
+//The orders resting at one price level, in time priority
+using OrderQueue = IntrusiveOrderList<LevelLinks>;
+
+//A book's resting GoodForDay orders, oldest first
+using ExpiryList = IntrusiveOrderList<ExpiryLinks>;
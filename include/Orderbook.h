@@ -1,70 +1,121 @@
 #pragma once 
 
-#include <map>
-#include <unordered_map>
-#include <thread>
+#include <chrono>
 #include <mutex> 
-#include <condition_variable>
+#include <span>
+#include <vector>
 
+#include "BookSnapshot.h"
+#include "Clock.h"
+#include "Command.h"
+#include "JournalRecord.h"
 #include "Order.h"
+#include "OrderIdIndex.h"
 #include "OrderModify.h"
+#include "OrderbookConfig.h"
+#include "OrderPool.h"
 #include "Orderbook_Level_Infos.h"
+#include "PriceLadder.h"
+#include "Seqlock.h"
+#include "SnapshotFile.h"
 #include "Trade.h"
+#include "TradeSink.h"
 #include "Usings.h"
 
 class Orderbook
 { 
     private: 
-        /* Bundles an order with its location to enable O(1) 
-        access within its level list*/
+        /* Locates an order's slot in the pool, which also gives O(1) 
+        access within its level queue*/
         struct OrderEntry
         {
-            OrderPointer order_{ nullptr }; 
-            OrderPointers::iterator location_; 
+            OrderIndex location_{ InvalidOrderIndex }; 
         };
 
-        /* Metadata with quantity of financial product and 
-        order count at each level */
-        struct LevelData
-        {
-            Quantity quantity_{ }; 
-            Quantity orderCount_{ }; 
-            
-            //Encapsulating actions that alter LevelData
-            enum class Action
-            { 
-                Add, 
-                Remove, 
-                Match
-            }; 
-        }; 
-        
-        std::unordered_map<Price, LevelData> data_; 
-        std::map<Price, OrderPointers, std::greater<Price>> bids_; 
-        std::map<Price, OrderPointers> asks_; 
-        std::unordered_map<OrderId, OrderEntry> orders_; 
+        PriceLadder<std::greater<Price>> bids_; 
+        PriceLadder<std::less<Price>> asks_; 
+        OrderIdIndex<OrderEntry> orders_; 
+        OrderPool pool_; 
+        ExpiryList goodForDayOrders_; 
+
+        std::size_t marketSweepLevels_; 
+        std::size_t expiryChunkSize_; 
+        bool singleWriter_; 
+        bool mirror_; 
+
+        //Top of book as of the last event, readable without the lock
+        Seqlock<BookSnapshot> snapshot_; 
 
         mutable std::mutex ordersMutex_; 
-        std::thread orderPruningThread_; 
-        std::condition_variable shutdownConditionVariable_; 
-        std::atomic<bool> shutdown_ { false }; 
 
-        /*A pruning clock that cancels GoodForDay orders at 4PM every day, designed to run on its own thread*/
-        void PruneGoodForDayOrders();
+        /*Expiry at the next close is registered only while GoodForDay 
+        orders rest, never for a single-writer book*/
+        Clock& clock_; 
+        Clock::TaskId expiryTask_{ Clock::NoTask }; 
+
+        //A queue being copied out by CaptureSnapshot and where its orders go
+        struct SnapshotCursor
+        {
+            OrderIndex index_{ InvalidOrderIndex }; 
+            SnapshotOrder* out_{ nullptr }; 
+        };
+
+        //Kept between captures, so walking the levels allocates nothing once warm
+        mutable std::vector<SnapshotCursor> snapshotCursors_; 
+
+        //Counts the commands that changed the book, the journal is optional
+        CommandJournal* journal_; 
+        std::uint64_t lastSequence_{ 0 }; 
+
+        /*Numbers a command that changed the book and hands it to the 
+        journal, called with the lock held so journal order is book order*/
+        void Record(const Command& command); 
 
-        /*Allows efficient bulk cancellation, for internal use*/
-        void CancelOrders(OrderIds orderIds);
+        /*Registers expiry at the next close if none is pending, called 
+        with the lock held as a GoodForDay order comes to rest*/
+        void ScheduleExpiry(); 
+
+        /*Scheduled at 4PM to cancel every GoodForDay order, clearing 
+        expiryTask_ once none are left so the next one registers again*/
+        void OnSessionClose(); 
+
+        //Cancels up to expiryChunkSize_ GoodForDay orders, called with the lock held
+        void ExpireChunk(); 
+
+        //Holds ordersMutex_, or nothing for a single-writer book
+        std::unique_lock<std::mutex> LockOrders() const; 
 
         /*Primary cancel function intended to be called only through other
-        thread-safe functions*/
-        void CancelOrderInternal(OrderId orderId);
-
-        /*APIs to update LevelData upon an order action*/
-        void OnOrderAdded(OrderPointer order); 
-        void OnOrderCancelled(OrderPointer order); 
-        void OnOrderMatched(Price price, Quantity quantity, 
-        bool isFullyFilled); 
-        void UpdateLevelData(Price price, Quantity quantity, LevelData::Action action);
+        thread-safe functions. Returns whether orderId was resting*/
+        bool CancelOrderInternal(OrderId orderId);
+
+        /*Bodies of the public add, modify and command APIs, called with the 
+        lock held. Each returns whether the book changed, so callers know 
+        whether to publish a snapshot*/
+        bool AddOrderInternal(Order& order, TradeSink sink); 
+        bool ModifyOrderInternal(const OrderModify& order, TradeSink sink); 
+        bool ApplyInternal(const Command& command, TradeSink sink); 
+
+        /*Puts an order into the pool, the id index, its level and, for 
+        GoodForDay, the expiry list, without matching it. Returns false, 
+        touching nothing, if the id index refuses the order's id*/
+        bool RestOrder(const Order& order); 
+
+        /*Queue an order at the back of its price level, or take it out of 
+        its level, keeping the level's aggregates in step*/
+        void LinkOrder(OrderIndex location, const Order& order); 
+        void UnlinkOrder(OrderIndex location, const Order& order); 
+
+        /*Hands a filled or cancelled order's slot back to the pool, taking 
+        it off the expiry list first*/
+        void ReleaseOrder(OrderIndex location); 
+
+        /*APIs to update a level's aggregates upon an order action*/
+        void OnOrderAdded(PriceLevel& level, const Order& order); 
+        void OnOrderCancelled(PriceLevel& level, const Order& order); 
+        void OnOrderMatched(PriceLevel& level, const Order& order, Quantity quantity); 
+        void UpdateLevelData(PriceLevel& level, Side side, Price price, 
+            Quantity quantity, PriceLevel::Action action);
         
 
         /*APIs to return whether an order can be matched for a trade or be
@@ -72,32 +123,110 @@ class Orderbook
         bool CanMatch(Side side, Price price) const; 
         bool CanFullyFill(Side side, Price price, Quantity quantity) const; 
 
-        /*Matches as many bid/ask orders as possible and returns 
-        resulting trades*/
-        Trades MatchOrders(); 
+        /*Captures the top of book into snapshot_, called with the lock 
+        held at the end of every event that changes the book*/
+        void PublishSnapshot(); 
+
+        /*Matches as many bid/ask orders as possible, handing each 
+        resulting trade to sink*/
+        void MatchOrders(TradeSink sink); 
+
+        /*Fills a market order against the opposite side from its best level, 
+        stopping at its protection price or the configured level count. 
+        The order never rests, whatever is left unfilled is dropped*/
+        void SweepMarketOrder(Order& order, TradeSink sink); 
+
+        template <typename Ladder>
+        void SweepLevels(Order& order, Ladder& ladder, TradeSink sink); 
 
 
     public: 
         
         Orderbook();
+        explicit Orderbook(const OrderbookConfig& config); 
         ~Orderbook(); 
         Orderbook(const Orderbook&) = delete; 
         void operator=(const Orderbook&) = delete; 
         Orderbook(Orderbook&&) = delete; 
         void operator=(Orderbook&& orderbook) = delete; 
 
-        /*Adds order and returns any resulting Trades*/
+        /*Adds order and returns any resulting Trades. The order is copied 
+        into the book's pool, which owns it from then on. An order whose id 
+        is already resting, or is the largest OrderId, is ignored*/
+        Trades AddOrder(Order order); 
+
+        /*Adds order and passes each resulting Trade to sink as it happens, 
+        allocating nothing. Reuse the sink's storage across calls*/
+        void AddOrder(Order order, TradeSink sink); 
+
+        /*Kept for callers that build orders on the heap, later fills are 
+        not reflected in the caller's copy*/
         Trades AddOrder(OrderPointer order); 
       
         void CancelOrder(OrderId orderId); 
 
-        /*Takes in an OrderModify object to find and cancel old order, 
-        re-adding the modified version. Returns any resulting Trades*/
+        /*Applies an OrderModify to a resting order under a single lock. 
+        Reducing quantity at the same price and side keeps time priority; 
+        any other change requeues the same order at the back of its new 
+        level. Returns any resulting Trades*/
         Trades ModifyOrder(OrderModify order); 
-
+        void ModifyOrder(OrderModify order, TradeSink sink); 
+
+        /*Applies an add, cancel or modify command to this book, whatever 
+        its symbol, passing any resulting Trade to sink. Returns false if 
+        the command was rejected or found nothing to act on*/
+        bool Apply(const Command& command, TradeSink sink); 
+
+        /*Applies commands in order under a single hold of the lock, passing 
+        every resulting Trade to sink, and publishes one snapshot for the 
+        whole batch. Commands that cannot cross skip matching entirely*/
+        void Submit(std::span<const Command> commands, TradeSink sink); 
+
+        /*Applies journalled commands under one hold of the lock without 
+        journalling them again, skipping any at or below LastSequence. 
+        Fills are discarded, they were delivered before the restart*/
+        void Replay(std::span<const JournalRecord> records); 
+
+        /*Copies the resting orders out under one hold of the lock for a 
+        SnapshotWriter to write on its own thread. Costs the matcher a walk 
+        of the live orders and no I/O; capturing into a reused image, such 
+        as SnapshotWriter::SpareImage, also avoids allocating*/
+        SnapshotImage CaptureSnapshot() const; 
+        void CaptureSnapshot(SnapshotImage& image) const; 
+
+        /*Rests a snapshot's orders in an empty book without matching them, 
+        keeping their queue positions and fills, and takes its sequence. 
+        Replaying the journal from there completes a restart. Throws 
+        std::logic_error if the book already holds orders, or if the 
+        snapshot repeats an order id or uses the reserved one, after which 
+        the book is part restored and should be discarded*/
+        void Restore(std::span<const SnapshotOrder> orders, std::uint64_t lastSequence); 
+
+        //Sequence number of the last command that changed the book
+        std::uint64_t LastSequence() const; 
+
+        /*Cancels resting GoodForDay orders, as the scheduled expiry does at 4PM. 
+        Only those orders are visited, oldest first, in chunks of 
+        expiryChunkSize_ with the lock released between chunks*/
+        void PruneGoodForDayOrdersNow(); 
+
+        //config.clock_, or the wall clock if none was given
+        Clock& GetClock() const { return clock_; }
+
+        //The next 4PM local time after now, when GoodForDay orders expire
+        static std::chrono::system_clock::time_point NextSessionClose(
+            std::chrono::system_clock::time_point now); 
+
+        //Never blocks, read from the published snapshot
         std::size_t Size() const; 
+
+        /*Best prices and the top BookSnapshot::MaxDepth levels per side as 
+        of the last event. Never blocks the matcher, safe from any thread 
+        even for a single-writer book*/
+        BookSnapshot GetSnapshot() const; 
         
-        //Returns compilation of orderbook's current bid/ask information  
+        /*Returns compilation of orderbook's current bid/ask information. 
+        Walks every level under the lock, prefer GetSnapshot for polling*/
         OrderbookLevelInfos GetOrderInfos() const; 
     
 }; 
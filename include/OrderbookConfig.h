@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Usings.h"
+
+class Clock; 
+class CommandJournal; 
+
+//Tuning knobs fixed for the lifetime of an Orderbook
+struct OrderbookConfig 
+{ 
+    /*Each side's price ladder covers bandTicks_ levels centered on 
+    referencePrice_, or on the first price seen when none is given*/
+    Price referencePrice_{ }; 
+    std::size_t bandTicks_{ 4096 }; 
+
+    //Set when the venue assigns order ids sequentially
+    bool sequentialOrderIds_{ false }; 
+
+    /*Resting order count to preallocate the order pool and id index for. 
+    Zero starts both small and lets them double as orders arrive*/
+    std::size_t expectedOrders_{ 0 }; 
+
+    //Most price levels a market order may sweep, zero for no limit
+    std::size_t marketSweepLevels_{ 0 }; 
+
+    /*Set when a single thread owns the book and makes every call, as 
+    OrderbookEngine does. No lock is taken and no expiry is scheduled, 
+    the owner calls PruneGoodForDayOrdersNow at the session close instead*/
+    bool singleWriter_{ false }; 
+
+    /*Set for a book that mirrors another venue's book from its feed, as 
+    ItchFeedHandler builds. Orders rest where the feed puts them and never 
+    match, even if a bad capture crosses the book, and market orders are 
+    rejected. The venue's own executions arrive as reductions instead*/
+    bool mirror_{ false }; 
+
+    /*Most GoodForDay orders expired per hold of the lock at the close, so 
+    matching is never paused for long*/
+    std::size_t expiryChunkSize_{ 1024 }; 
+
+    /*Tells the time and runs timed events such as expiry, 
+    WallClock::Instance() if null. Give a SimulatedClock for replay*/
+    Clock* clock_{ nullptr }; 
+
+    /*Receives every command that changed the book, GoodForDay expiries 
+    included, numbered with the book's own sequence. One journal per book*/
+    CommandJournal* journal_{ nullptr }; 
+
+    //A copy with singleWriter_ set, for owners that give a book its own thread
+    OrderbookConfig SingleWriter() const 
+    { 
+        auto config = *this; 
+        config.singleWriter_ = true; 
+        return config; 
+    }
+}; 
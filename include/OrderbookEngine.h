@@ -0,0 +1,89 @@
+#pragma once 
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "Command.h"
+#include "Orderbook.h"
+#include "OrderbookConfig.h"
+#include "SpscRing.h"
+#include "Trade.h"
+
+/*Runs one Orderbook on a dedicated thread, the only one ever to touch it, 
+  so the book is built single-writer and takes no locks. Each client owns a 
+  request ring it pushes commands into and a response ring it polls for 
+  their outcome. The engine busy-polls the request rings and makes no system 
+  call while there is work, yielding only after a run of empty polls. The 
+  engine thread also expires GoodForDay orders at the close, see MatcherLoop*/
+class OrderbookEngine
+{ 
+    public: 
+        static constexpr std::size_t RingCapacity{ 1 << 12 }; 
+
+        /*What became of a client's command, matched to it by tag_. Each fill 
+        the command caused comes back first, then exactly one Done*/
+        struct Response
+        {
+            enum class Kind : std::uint8_t
+            { 
+                Fill, 
+                Done 
+            }; 
+
+            Kind kind_{ Kind::Done }; 
+            std::uint64_t tag_{ }; 
+            Trade trade_{ }; 
+        }; 
+
+    private: 
+        struct Request
+        {
+            Command command_{ }; 
+            std::uint64_t tag_{ }; 
+        }; 
+
+        struct Client
+        {
+            SpscRing<Request, RingCapacity> requests_; 
+            SpscRing<Response, RingCapacity> responses_; 
+        }; 
+
+        std::vector<std::unique_ptr<Client>> clients_; 
+
+        Orderbook book_; 
+        std::atomic<bool> stop_{ false }; 
+
+        //Declared last so it starts only once the rings and book exist
+        std::thread thread_; 
+
+        //Matching loop run on the engine's own thread
+        void Run(); 
+
+        /*Waits for room in the client's response ring, a client that stops 
+        polling stalls the engine*/
+        void Respond(Client& client, const Response& response); 
+
+    public: 
+
+        /*Starts the engine thread for a book built from config, serving 
+        clientCount clients numbered from zero*/
+        explicit OrderbookEngine(std::size_t clientCount, 
+            const OrderbookConfig& config = OrderbookConfig{ }); 
+        ~OrderbookEngine(); 
+        OrderbookEngine(const OrderbookEngine&) = delete; 
+        void operator=(const OrderbookEngine&) = delete; 
+        OrderbookEngine(OrderbookEngine&&) = delete; 
+        void operator=(OrderbookEngine&&) = delete; 
+
+        /*Queues command for the engine, returning false if client's request 
+        ring is full. Each client must call only from a single thread*/
+        bool TrySubmit(std::size_t client, const Command& command, std::uint64_t tag); 
+
+        //Takes client's next response, returning false if there is none yet
+        bool TryPoll(std::size_t client, Response& response); 
+
+        std::size_t ClientCount() const { return clients_.size(); }
+}; 
@@ -0,0 +1,89 @@
+#pragma once 
+
+#include <mutex> 
+#include <atomic>
+#include <span>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "Command.h"
+#include "Orderbook.h"
+#include "OrderbookConfig.h"
+#include "Trade.h"
+#include "Usings.h"
+
+/*Owns one Orderbook per symbol and partitions them across shards, each 
+  with its own matching thread. A symbol always belongs to the shard 
+  symbolId % shard count, so every command for it is applied in submission 
+  order by one thread. Submitters only ever touch the owning shard's queue, 
+  there is no lock shared across shards*/
+class OrderbookManager
+{ 
+    public: 
+        //Receives each fill on the matching thread of the symbol's shard
+        using TradeListener = std::function<void(SymbolId symbolId, const Trade& trade)>; 
+
+    private: 
+        /*A matching thread and the books it owns. Submitters append to 
+        pending_, the thread swaps the whole batch out under the mutex and 
+        applies it without holding it*/
+        struct Shard
+        {
+            mutable std::mutex mutex_; 
+            std::condition_variable pendingConditionVariable_; 
+            std::condition_variable idleConditionVariable_; 
+            std::vector<Command> pending_; 
+            std::uint64_t submitted_{ }; 
+            std::uint64_t applied_{ }; 
+            bool shutdown_{ false }; 
+
+            /*Books are created by the shard thread, under mutex_ so readers 
+            on other threads can look them up, and are never erased*/
+            std::unordered_map<SymbolId, std::unique_ptr<Orderbook>> books_; 
+            std::thread thread_; 
+        };
+
+        OrderbookConfig bookConfig_; 
+        TradeListener tradeListener_; 
+        std::vector<std::unique_ptr<Shard>> shards_; 
+
+        Shard& ShardFor(SymbolId symbolId) { return *shards_[ShardIndexOf(symbolId)]; }
+        const Shard& ShardFor(SymbolId symbolId) const { return *shards_[ShardIndexOf(symbolId)]; }
+
+        //Matching loop run by each shard's thread
+        void RunShard(Shard& shard); 
+        //Applies commands, all for one symbol, to its book in one batch
+        void Apply(Shard& shard, std::span<const Command> commands); 
+
+    public: 
+
+        /*Starts shardCount matching threads, defaulting to one per core. 
+        Every book is created with bookConfig on first use*/
+        explicit OrderbookManager(std::size_t shardCount = 0, 
+            const OrderbookConfig& bookConfig = OrderbookConfig{ }, 
+            TradeListener tradeListener = nullptr); 
+        ~OrderbookManager(); 
+        OrderbookManager(const OrderbookManager&) = delete; 
+        void operator=(const OrderbookManager&) = delete; 
+        OrderbookManager(OrderbookManager&&) = delete; 
+        void operator=(OrderbookManager&&) = delete; 
+
+        /*Queues command for the shard owning its symbol and returns without 
+        waiting for it to be applied*/
+        void Submit(const Command& command); 
+
+        //Blocks until every command submitted so far has been applied
+        void Flush(); 
+
+        std::size_t ShardCount() const { return shards_.size(); }
+        std::size_t ShardIndexOf(SymbolId symbolId) const { return symbolId % shards_.size(); }
+
+        /*Orders resting in symbol's book, zero if it has not seen a command. 
+        Reflects only commands already applied, call Flush first as needed*/
+        std::size_t Size(SymbolId symbolId) const; 
+        OrderbookLevelInfos GetOrderInfos(SymbolId symbolId) const; 
+}; 
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <bit>
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "FenwickTree.h"
+#include "PriceLevel.h"
+#include "Usings.h"
+
+/*One side of the orderbook's price levels. Prices inside a band of ticks
+  around a reference price live in a contiguous array indexed by tick offset,
+  giving O(1) level lookup and tracked cursors over the occupied span. Prices outside the
+  band fall back to a tree. A bitmap of occupied slots lets walks and cursor
+  moves skip 64 empty ticks per word rather than testing each. Compare orders prices from best to worst, i.e.
+  std::greater<Price> for bids and std::less<Price> for asks. The quantity
+  resting at each price is also summed in price order, so depth up to a
+  limit price is known in O(log n) without visiting the levels*/
+template <typename Compare>
+class PriceLadder
+{
+public:
+    using Level = PriceLevel;
+
+    static constexpr std::size_t DefaultBandTicks{ 4096 };
+
+    //The band is allocated when first anchored, so an idle side costs nothing
+    explicit PriceLadder(std::size_t bandTicks = DefaultBandTicks)
+        : bandTicks_{ bandTicks }, depth_{ 0 }
+    { }
+
+    /*Centers the band on referencePrice. Ignored unless the ladder is empty,
+    as resting levels cannot move between the band and the tree*/
+    void Anchor(Price referencePrice)
+    {
+        if (!Empty() || !referencePrice.HasValue() || !bandTicks_)
+            return;
+
+        if (levels_.empty())
+        {
+            levels_.resize(bandTicks_);
+            occupancy_.resize((bandTicks_ + WordBits - 1) / WordBits);
+            depth_ = FenwickTree{ bandTicks_ };
+        }
+
+        baseTicks_ = referencePrice.Ticks() - static_cast<Price::Representation>(levels_.size() / 2);
+        anchored_ = true;
+    }
+
+    bool Empty() const { return !occupied_ && overflow_.empty(); }
+
+    /*Returns the level at price, creating it if needed. The caller is
+    expected to add an order to it*/
+    Level& GetOrCreateLevel(Price price)
+    {
+        if (!anchored_ || (Empty() && !InBand(price)))
+            Anchor(price);
+
+        if (!InBand(price))
+            return overflow_[price];
+
+        const auto index = IndexOf(price);
+        if (levels_[index].Empty())
+            MarkOccupied(index);
+
+        return levels_[index];
+    }
+
+    //Returns the level at price, or nullptr if no orders rest there
+    Level* FindLevel(Price price)
+    {
+        if (InBand(price))
+        {
+            auto& level = levels_[IndexOf(price)];
+            return level.Empty() ? nullptr : &level;
+        }
+
+        auto iterator = overflow_.find(price);
+        return iterator == overflow_.end() ? nullptr : &iterator->second;
+    }
+
+    //Drops the level at price, called once its last order is gone
+    void EraseLevel(Price price)
+    {
+        if (!InBand(price))
+        {
+            overflow_.erase(price);
+            return;
+        }
+
+        const auto index = IndexOf(price);
+        if (!occupied_ || index < low_ || index > high_)
+            return;
+
+        MarkVacant(index);
+    }
+
+    //Best price/level, only valid when the ladder is not empty
+    Price BestPrice() const { return BestIsInBand() ? PriceAt(BestIndex()) : overflow_.begin()->first; }
+    Level& BestLevel() { return BestIsInBand() ? levels_[BestIndex()] : overflow_.begin()->second; }
+
+    //Whether price ranks strictly ahead of other on this side
+    static bool IsBetter(Price price, Price other) { return Compare{}(price, other); }
+
+    /*Records quantity resting at price growing or shrinking by delta. Levels
+    outside the band are summed from their own aggregates when queried*/
+    void AddDepth(Price price, std::int64_t delta)
+    {
+        if (!InBand(price))
+            return;
+
+        depth_.Add(IndexOf(price), delta);
+        bandDepth_ += delta;
+    }
+
+    //Whether at least quantity rests at prices better than or equal to limit
+    bool HasDepth(Price limit, Quantity quantity) const
+    {
+        std::int64_t depth{ };
+        if (anchored_)
+        {
+            //Count of band slots below the first one holding limit or a better price
+            const auto units = static_cast<std::int64_t>(limit.Units());
+            const auto floorTicks = units / Price::Tick - (units % Price::Tick < 0 ? 1 : 0);
+            const auto ceilTicks = floorTicks + (units % Price::Tick ? 1 : 0);
+            const auto bandSize = static_cast<std::int64_t>(levels_.size());
+            const auto boundary = static_cast<std::size_t>(Descending
+                ? std::clamp<std::int64_t>(ceilTicks - baseTicks_, 0, bandSize)
+                : std::clamp<std::int64_t>(floorTicks + 1 - baseTicks_, 0, bandSize));
+
+            depth = Descending ? bandDepth_ - depth_.PrefixSum(boundary) : depth_.PrefixSum(boundary);
+        }
+
+        for (auto iterator = overflow_.begin(); depth < quantity 
+            && iterator != overflow_.end() && !Compare{}(limit, iterator->first); ++iterator)
+            depth += iterator->second.quantity_;
+
+        return depth >= quantity;
+    }
+
+    /*Visits every non-empty level from best to worst price. Visiting stops
+    early once visitor returns false*/
+    template <typename Visitor>
+    void ForEachLevel(Visitor visitor) const
+    {
+        auto iterator = overflow_.begin();
+
+        if (occupied_)
+        {
+            const auto bandBest = PriceAt(BestIndex());
+            for (; iterator != overflow_.end() && Compare{}(iterator->first, bandBest); ++iterator)
+                if (!visitor(iterator->first, iterator->second))
+                    return;
+
+            //The cursors are occupied, so each step lands on a live level
+            for (auto index = BestIndex(); ; index = Descending ? PreviousOccupied(index - 1) : NextOccupied(index + 1))
+            {
+                if (!visitor(PriceAt(index), levels_[index]))
+                    return;
+                if (index == (Descending ? low_ : high_))
+                    break;
+            }
+        }
+
+        for (; iterator != overflow_.end(); ++iterator)
+            if (!visitor(iterator->first, iterator->second))
+                return;
+    }
+
+private:
+    //True when better prices are higher prices, i.e. for bids
+    static constexpr bool Descending{ Compare{}(Price::FromTicks(1), Price::FromTicks(0)) };
+
+    static constexpr std::size_t WordBits{ 64 };
+
+    //Off-tick prices cannot share a slot with their tick, so they use the tree
+    bool InBand(Price price) const
+    {
+        if (!anchored_ || !price.HasValue() || !price.IsOnTick())
+            return false;
+
+        const auto offset = static_cast<std::int64_t>(price.Ticks()) - baseTicks_;
+        return offset >= 0 && offset < static_cast<std::int64_t>(levels_.size());
+    }
+
+    std::size_t IndexOf(Price price) const { return static_cast<std::size_t>(price.Ticks() - baseTicks_); }
+    Price PriceAt(std::size_t index) const { return Price::FromTicks(baseTicks_ + static_cast<Price::Representation>(index)); }
+
+    std::size_t BestIndex() const { return Descending ? high_ : low_; }
+
+    bool BestIsInBand() const
+    {
+        if (!occupied_)
+            return false;
+        if (overflow_.empty())
+            return true;
+
+        const auto& [treeBest, _] = *overflow_.begin();
+        return Compare{}(PriceAt(BestIndex()), treeBest);
+    }
+
+    //First occupied slot at or above index, which must exist
+    std::size_t NextOccupied(std::size_t index) const
+    {
+        auto word = index / WordBits;
+        auto bits = occupancy_[word] & (~std::uint64_t{ } << (index % WordBits));
+        while (!bits)
+            bits = occupancy_[++word];
+        return word * WordBits + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+
+    //Last occupied slot at or below index, which must exist
+    std::size_t PreviousOccupied(std::size_t index) const
+    {
+        auto word = index / WordBits;
+        auto bits = occupancy_[word] & (~std::uint64_t{ } >> (WordBits - 1 - index % WordBits));
+        while (!bits)
+            bits = occupancy_[--word];
+        return word * WordBits + WordBits - 1 - static_cast<std::size_t>(std::countl_zero(bits));
+    }
+
+    void MarkOccupied(std::size_t index)
+    {
+        occupancy_[index / WordBits] |= std::uint64_t{ 1 } << (index % WordBits);
+        if (!occupied_)
+            low_ = high_ = index;
+        else
+        {
+            low_ = std::min(low_, index);
+            high_ = std::max(high_, index);
+        }
+        ++occupied_;
+    }
+
+    //Moves the cursors past the vacated level to the nearest occupied one
+    void MarkVacant(std::size_t index)
+    {
+        occupancy_[index / WordBits] &= ~(std::uint64_t{ 1 } << (index % WordBits));
+        if (!--occupied_)
+            return;
+
+        if (index == low_)
+            low_ = NextOccupied(low_);
+
+        if (index == high_)
+            high_ = PreviousOccupied(high_);
+    }
+
+    std::size_t bandTicks_;
+    std::vector<Level> levels_;
+    std::vector<std::uint64_t> occupancy_;
+    std::map<Price, Level, Compare> overflow_;
+    FenwickTree depth_;
+    std::int64_t bandDepth_{ };
+    Price::Representation baseTicks_{ };
+    bool anchored_{ false };
+    std::size_t occupied_{ };
+    std::size_t low_{ };
+    std::size_t high_{ };
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "OrderQueue.h"
+
+/*The orders resting at one price together with their total remaining
+  quantity and order count, kept current by the orderbook as orders are
+  added, cancelled and matched*/
+struct PriceLevel
+{
+    //Encapsulating actions that alter a level's aggregates
+    enum class Action
+    {
+        Add,
+        Remove,
+        Match
+    };
+
+    OrderQueue orders_;
+    Quantity quantity_{ };
+    Quantity orderCount_{ };
+
+    bool Empty() const { return orders_.Empty(); }
+};
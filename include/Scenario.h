@@ -0,0 +1,83 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+#include "Command.h"
+#include "OrderbookConfig.h"
+#include "Usings.h"
+
+class ScenarioReader;
+
+//What a scenario expects to be left in the book once it has been replayed
+struct ScenarioResult
+{
+    std::size_t allCount_{ };
+    std::size_t bidCount_{ };
+    std::size_t askCount_{ };
+
+    bool operator==(const ScenarioResult&) const = default;
+};
+
+/*A replayable session: one command per line,
+    A <B|S> <OrderType> <price> <quantity> <orderId>
+    M <orderId> <B|S> <price> <quantity>
+    C <orderId>
+  optionally closed by "R <orders> <bid levels> <ask levels>". Captured
+  market data carries no R line and is only replayed*/
+struct Scenario
+{
+    std::vector<Command> commands_;
+    std::optional<ScenarioResult> expected_;
+};
+
+/*Collects a scenario's commands into memory, reading them through a
+  ScenarioReader. Throws std::logic_error on the first bad line*/
+class ScenarioParser
+{
+    public:
+        Scenario Parse(const std::filesystem::path& path) const;
+
+        //Parsing stops at the first empty line, as it does for files
+        Scenario ParseText(std::string_view text) const;
+};
+
+//What replaying a scenario left behind
+struct ScenarioOutcome
+{
+    ScenarioResult actual_{ };
+    std::size_t commands_{ };
+    std::size_t trades_{ };
+
+    //True when the scenario expects nothing or its R line matched
+    bool Passed(const Scenario& scenario) const
+    {
+        return !scenario.expected_ || *scenario.expected_ == actual_;
+    }
+};
+
+/*How a replay hands commands to the book: in one Submit batch, or one
+  AddOrder, ModifyOrder or CancelOrder call each, so the per-call APIs
+  are exercised by the same files*/
+enum class ReplayMode
+{
+    Batched,
+    PerCall
+};
+
+//Replays every command in order on a fresh book built from config
+ScenarioOutcome ReplayScenario(std::span<const Command> commands, const OrderbookConfig& config = { },
+    ReplayMode mode = ReplayMode::Batched);
+
+inline ScenarioOutcome ReplayScenario(const Scenario& scenario, const OrderbookConfig& config = { },
+    ReplayMode mode = ReplayMode::Batched)
+{
+    return ReplayScenario(scenario.commands_, config, mode);
+}
+
+/*Applies each command as reader parses it, so a long text session is never
+  held in memory whole. The R line's counts are in reader.Expected() after*/
+ScenarioOutcome ReplayScenario(ScenarioReader& reader, const OrderbookConfig& config = { });
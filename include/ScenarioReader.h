@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+#include "Command.h"
+#include "MappedFile.h"
+#include "Scenario.h"
+
+/*Streams the commands of a scenario (see Scenario for the format) straight
+  out of a memory-mapped file or a caller's buffer. Line ends are found with
+  memchr, which libc vectorizes, and fields are parsed in place into one
+  reused Command, so reading allocates nothing per line. Iteration stops at
+  the first empty line or at the R line, whose counts Expected() returns
+  from then on. Throws std::logic_error, naming the line, on bad input*/
+class ScenarioReader
+{
+    private:
+        std::unique_ptr<MappedFile> file_;
+        std::string_view text_;
+        std::optional<ScenarioResult> expected_;
+
+    public:
+        class Iterator
+        {
+            private:
+                ScenarioReader* reader_{ nullptr };
+                const char* cursor_{ nullptr };
+                const char* end_{ nullptr };
+                std::size_t lineNumber_{ 0 };
+                Command command_{ };
+
+                //Parses lines until a command is read, clearing reader_ at the end
+                void Advance();
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = Command;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() = default;
+                explicit Iterator(ScenarioReader& reader);
+
+                const Command& operator*() const { return command_; }
+                const Command* operator->() const { return &command_; }
+                Iterator& operator++() { Advance(); return *this; }
+                void operator++(int) { Advance(); }
+
+                bool operator==(std::default_sentinel_t) const { return reader_ == nullptr; }
+        };
+
+        //Maps path for the reader's lifetime
+        explicit ScenarioReader(const std::filesystem::path& path);
+
+        //Reads text in place, which must outlive the reader
+        explicit ScenarioReader(std::string_view text);
+
+        Iterator begin() { return Iterator{ *this }; }
+        std::default_sentinel_t end() const { return { }; }
+
+        //The R line's counts, known once iteration has reached it
+        const std::optional<ScenarioResult>& Expected() const { return expected_; }
+
+        //Bytes the reader covers, for sizing and throughput figures
+        std::size_t Size() const { return text_.size(); }
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "CacheLine.h"
+
+/*Publishes a trivially copyable value from one writer to any number of
+  readers without ever blocking the writer. The sequence is odd while a
+  store is under way; a reader copies the value and keeps it only if the
+  sequence was even and unchanged across the copy. The value is held as
+  atomic words so a torn read is a retry, never a data race. Stores must be
+  serialized by the caller*/
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied word by word");
+
+public:
+    void Store(const T& value)
+    {
+        std::array<std::uint64_t, Words> words{ };
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t word = 0; word < Words; ++word)
+            words_[word].store(words[word], std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    //Returns false if a store overlapped the copy
+    bool TryLoad(T& value) const
+    {
+        const auto before = sequence_.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+
+        std::array<std::uint64_t, Words> words;
+        for (std::size_t word = 0; word < Words; ++word)
+            words[word] = words_[word].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before)
+            return false;
+
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return true;
+    }
+
+    //Retries until a copy completes without a store overlapping it
+    T Load() const
+    {
+        T value{ };
+        while (!TryLoad(value))
+            ;
+        return value;
+    }
+
+    //Number of completed stores
+    std::uint64_t Version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t Words{ (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) };
+
+    alignas(CacheLineSize) std::atomic<std::uint64_t> sequence_{ };
+    std::array<std::atomic<std::uint64_t>, Words> words_{ };
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "BookSnapshot.h"
+#include "CacheLine.h"
+#include "Command.h"
+#include "MpscSequencer.h"
+#include "Orderbook.h"
+#include "OrderbookConfig.h"
+#include "Trade.h"
+
+//A command as the sequencer ordered it, sequence_ counts from one per book
+struct SequencedCommand
+{
+    std::uint64_t sequence_{ };
+    std::uint32_t producer_{ };
+    Command command_{ };
+};
+
+/*Puts an MpscSequencer in front of one single-writer Orderbook. Any number
+  of producer threads Submit commands without a lock; each is stamped with
+  the next global sequence number and a matcher thread, the only one to touch
+  the book, applies them strictly in that order. The stream is therefore the
+  same on every replay of it, and counters kept per producer show how the
+  book's throughput is shared out. The matcher also expires GoodForDay
+  orders at the close, see MatcherLoop*/
+class SequencedOrderbook
+{
+    public:
+        static constexpr std::size_t RingCapacity{ 1 << 12 };
+
+        //Called on the matcher thread for each fill, with the command that caused it
+        using TradeListener = std::function<void(const SequencedCommand& command, const Trade& trade)>;
+
+        struct ProducerStats
+        {
+            std::uint64_t submitted_{ };
+            std::uint64_t stalls_{ };
+            std::uint64_t applied_{ };
+            std::uint64_t rejected_{ };
+            std::uint64_t trades_{ };
+        };
+
+    private:
+        //Written by the producer and by the matcher respectively, so kept on separate lines
+        struct alignas(CacheLineSize) ProducerSide
+        {
+            std::atomic<std::uint64_t> submitted_{ };
+            std::atomic<std::uint64_t> stalls_{ };
+        };
+
+        struct alignas(CacheLineSize) MatcherSide
+        {
+            std::atomic<std::uint64_t> applied_{ };
+            std::atomic<std::uint64_t> rejected_{ };
+            std::atomic<std::uint64_t> trades_{ };
+        };
+
+        struct Producer
+        {
+            ProducerSide producerSide_;
+            MatcherSide matcherSide_;
+        };
+
+        std::unique_ptr<MpscSequencer<SequencedCommand, RingCapacity>> sequencer_;
+        std::vector<std::unique_ptr<Producer>> producers_;
+        TradeListener tradeListener_;
+
+        Orderbook book_;
+        alignas(CacheLineSize) std::atomic<std::uint64_t> lastApplied_{ 0 };
+        std::atomic<bool> stop_{ false };
+
+        //Declared last so it starts only once the sequencer and book exist
+        std::thread thread_;
+
+        //Matching loop run on the matcher's own thread
+        void Run();
+
+    public:
+
+        /*Starts the matcher thread for a book built from config, fed by
+        producerCount producers numbered from zero*/
+        explicit SequencedOrderbook(std::size_t producerCount,
+            const OrderbookConfig& config = OrderbookConfig{ },
+            TradeListener tradeListener = nullptr);
+
+        //Applies every command submitted before destruction
+        ~SequencedOrderbook();
+        SequencedOrderbook(const SequencedOrderbook&) = delete;
+        void operator=(const SequencedOrderbook&) = delete;
+        SequencedOrderbook(SequencedOrderbook&&) = delete;
+        void operator=(SequencedOrderbook&&) = delete;
+
+        /*Any thread, waiting only while the ring is full. Returns the
+        sequence number the command will be applied at*/
+        std::uint64_t Submit(std::size_t producer, const Command& command);
+
+        //Blocks until every command submitted before the call has been applied
+        void Flush() const;
+
+        //Sequence number of the last command applied, zero before the first
+        std::uint64_t LastApplied() const { return lastApplied_.load(std::memory_order_acquire); }
+
+        ProducerStats GetProducerStats(std::size_t producer) const;
+        std::size_t ProducerCount() const { return producers_.size(); }
+
+        BookSnapshot GetSnapshot() const { return book_.GetSnapshot(); }
+        std::size_t Size() const { return book_.Size(); }
+};
@@ -0,0 +1,67 @@
+#pragma once 
+
+#include <map>
+#include <mutex> 
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+/*Runs timed book events, such as GoodForDay expiry at the close, on a 
+  small pool of timer threads shared by every book in the process. Books 
+  register a task only once they have something to do at that time, so an 
+  idle book costs no thread, no condition variable and no join*/
+class SessionScheduler
+{ 
+    public: 
+        using TimePoint = std::chrono::system_clock::time_point; 
+        using TaskId = std::uint64_t; 
+        using Task = std::function<void()>; 
+
+        //Never returned by ScheduleAt
+        static constexpr TaskId NoTask{ 0 }; 
+
+    private: 
+        mutable std::mutex mutex_; 
+        std::condition_variable tasksConditionVariable_; 
+        std::condition_variable finishedConditionVariable_; 
+
+        //Due time ordered, ties run in scheduling order
+        std::map<std::pair<TimePoint, TaskId>, Task> tasks_; 
+        std::unordered_map<TaskId, TimePoint> dueTimes_; 
+        std::vector<TaskId> running_; 
+        TaskId nextTaskId_{ NoTask + 1 }; 
+        bool shutdown_{ false }; 
+
+        //Declared last so they start only once everything they use exists
+        std::vector<std::thread> threads_; 
+
+        //Timer loop run by each pool thread
+        void Run(); 
+
+    public: 
+
+        explicit SessionScheduler(std::size_t threadCount = 1); 
+        ~SessionScheduler(); 
+        SessionScheduler(const SessionScheduler&) = delete; 
+        void operator=(const SessionScheduler&) = delete; 
+        SessionScheduler(SessionScheduler&&) = delete; 
+        void operator=(SessionScheduler&&) = delete; 
+
+        //The scheduler books use unless their config names another
+        static SessionScheduler& Instance(); 
+
+        /*Runs task on a timer thread at when, or as soon as possible if 
+        when has passed. Tasks still pending at destruction never run*/
+        TaskId ScheduleAt(TimePoint when, Task task); 
+
+        /*Drops a pending task, returning false if it already ran. If the 
+        task is running on another thread, waits for it to finish, so its 
+        owner can be destroyed straight after*/
+        bool Cancel(TaskId taskId); 
+
+        std::size_t Pending() const; 
+}; 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+
+#include "MappedFile.h"
+#include "Usings.h"
+
+/*One resting order as a snapshot stores it. Bids come first, best price
+  first and in time priority within each level, then asks the same way, so
+  restoring them in file order rebuilds every queue exactly*/
+struct SnapshotOrder
+{
+    OrderId orderId_{ };
+    Price price_{ };
+    Quantity initialQuantity_{ };
+    Quantity remainingQuantity_{ };
+    std::uint8_t orderType_{ };
+    std::uint8_t side_{ };
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotOrder>, "Snapshot orders are written byte for byte");
+static_assert(sizeof(SnapshotOrder) == 24, "Changing the order layout needs a new snapshot version");
+
+/*A book's resting orders as of the command numbered lastSequence_, as 
+  copied out on the matcher: only the live orders, walked level by level in 
+  the order a snapshot file lists them. An image may be reused across 
+  captures, its buffer then stops allocating once it fits the book*/
+struct SnapshotImage
+{
+    std::uint64_t lastSequence_{ };
+    std::vector<SnapshotOrder> orders_;
+};
+
+/*Writes image to a temporary file beside path, syncs it and renames it
+  over path, so a crash leaves either the old snapshot or the new one.
+  Throws std::system_error on I/O failure*/
+void WriteSnapshotFile(const std::filesystem::path& path, const SnapshotImage& image);
+
+/*Maps a snapshot file and checks its header, after which the orders are
+  read in place. Throws std::logic_error for a file of another version or
+  a truncated one*/
+class SnapshotReader
+{
+    public:
+        static constexpr std::uint32_t Version{ 1 };
+
+    private:
+        MappedFile file_;
+        std::uint64_t lastSequence_{ };
+        std::span<const SnapshotOrder> orders_;
+
+    public:
+        explicit SnapshotReader(const std::filesystem::path& path);
+
+        std::uint64_t LastSequence() const { return lastSequence_; }
+        std::span<const SnapshotOrder> Orders() const { return orders_; }
+};
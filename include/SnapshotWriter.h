@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <condition_variable>
+
+#include "SnapshotFile.h"
+
+/*Writes snapshot images on its own thread, so the matcher only pays for
+  copying its orders out with Orderbook::CaptureSnapshot and never for the
+  disk. Images are written in the order they were queued*/
+class SnapshotWriter
+{
+    private:
+        struct Job
+        {
+            std::filesystem::path path_;
+            SnapshotImage image_;
+        };
+
+        std::mutex mutex_;
+        std::condition_variable pendingConditionVariable_;
+        std::condition_variable idleConditionVariable_;
+        std::deque<Job> pending_;
+        bool writing_{ false };
+        bool shutdown_{ false };
+        std::exception_ptr error_;
+        std::uint64_t lastWritten_{ 0 };
+
+        //The last image written, kept so its buffer can be captured into again
+        SnapshotImage spare_;
+
+        //Declared last so it starts only once everything it uses exists
+        std::thread thread_;
+
+        //Write loop run by the writer thread
+        void Run();
+
+    public:
+        SnapshotWriter();
+
+        //Writes every image queued before destruction
+        ~SnapshotWriter();
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        void operator=(const SnapshotWriter&) = delete;
+        SnapshotWriter(SnapshotWriter&&) = delete;
+        void operator=(SnapshotWriter&&) = delete;
+
+        //Queues image to be written to path, returns at once
+        void Write(std::filesystem::path path, SnapshotImage image);
+
+        /*Blocks until every queued image is on disk, rethrowing the first
+        error a write hit. Returns the last written image's sequence*/
+        std::uint64_t Wait();
+
+        //An image already written, or an empty one, to capture the next snapshot into
+        SnapshotImage SpareImage();
+};
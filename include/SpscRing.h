@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "CacheLine.h"
+
+/*Bounded lock-free FIFO for exactly one producer thread and one consumer
+  thread. Each index is written by one side only and sits on its own cache
+  line next to that side's cached copy of the other index, so in steady
+  flow neither side touches the other's line except to refresh its copy
+  when the ring looks full or empty. Capacity - 1 elements fit at most*/
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 1 && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+    //Producer side only
+    bool TryPush(const T& value)
+    {
+        const auto tail = producer_.tail_.load(std::memory_order_relaxed);
+        const auto next = (tail + 1) & Mask;
+        if (next == producer_.cachedHead_)
+        {
+            producer_.cachedHead_ = consumer_.head_.load(std::memory_order_acquire);
+            if (next == producer_.cachedHead_)
+                return false;
+        }
+
+        slots_[tail] = value;
+        producer_.tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //Consumer side only
+    bool TryPop(T& value)
+    {
+        const auto head = consumer_.head_.load(std::memory_order_relaxed);
+        if (head == consumer_.cachedTail_)
+        {
+            consumer_.cachedTail_ = producer_.tail_.load(std::memory_order_acquire);
+            if (head == consumer_.cachedTail_)
+                return false;
+        }
+
+        value = slots_[head];
+        consumer_.head_.store((head + 1) & Mask, std::memory_order_release);
+        return true;
+    }
+
+    //Approximate when called concurrently with either side
+    bool Empty() const
+    {
+        return consumer_.head_.load(std::memory_order_acquire) 
+            == producer_.tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t Mask{ Capacity - 1 };
+
+    struct alignas(CacheLineSize) Producer
+    {
+        std::atomic<std::size_t> tail_{ };
+        std::size_t cachedHead_{ };
+    };
+
+    struct alignas(CacheLineSize) Consumer
+    {
+        std::atomic<std::size_t> head_{ };
+        std::size_t cachedTail_{ };
+    };
+
+    Producer producer_;
+    Consumer consumer_;
+    alignas(CacheLineSize) std::array<T, Capacity> slots_{ };
+};
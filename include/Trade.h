@@ -1,10 +1,13 @@
 #pragma once 
+#include <vector>
+
 #include "TradeInfo.h"
 
 //Encapsulates a completed trade
 class Trade
 { 
 public: 
+    Trade() = default; 
     Trade(const TradeInfo& bidTrade, const TradeInfo& askTrade)
         : bidTrade_{ bidTrade }, askTrade_ { askTrade }
         { }; 
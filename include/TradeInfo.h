@@ -5,7 +5,7 @@
 //A TradeInfo bundles details of a filled order (bid or ask) in a trade
 struct TradeInfo 
 { 
-    OrderId orderId_; 
+    OrderId orderId_{ }; 
     Price price_; 
-    Quantity quantity_; 
+    Quantity quantity_{ }; 
 }; 
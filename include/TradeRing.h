@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Trade.h"
+
+/*Fixed-capacity FIFO of trades that can be passed as a TradeSink and drained
+  between calls. It never allocates; a fill arriving while the ring is full
+  is rejected and counted, so Capacity should cover the largest sweep*/
+template <std::size_t Capacity>
+class TradeRing
+{
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+    bool Push(const Trade& trade)
+    {
+        if (Size() == Capacity)
+        {
+            ++overflowed_;
+            return false;
+        }
+
+        slots_[tail_++ & Mask] = trade;
+        return true;
+    }
+
+    void operator()(const Trade& trade) { Push(trade); }
+
+    bool Pop(Trade& trade)
+    {
+        if (Empty())
+            return false;
+
+        trade = slots_[head_++ & Mask];
+        return true;
+    }
+
+    const Trade& operator[](std::size_t index) const { return slots_[(head_ + index) & Mask]; }
+
+    std::size_t Size() const { return tail_ - head_; }
+    bool Empty() const { return head_ == tail_; }
+    std::size_t Overflowed() const { return overflowed_; }
+
+    void Clear()
+    {
+        head_ = tail_ = 0;
+        overflowed_ = 0;
+    }
+
+private:
+    static constexpr std::size_t Mask{ Capacity - 1 };
+
+    std::array<Trade, Capacity> slots_{ };
+    std::size_t head_{ };
+    std::size_t tail_{ };
+    std::size_t overflowed_{ };
+};
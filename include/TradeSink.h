@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <concepts>
+#include <type_traits>
+
+#include "Trade.h"
+
+/*Non-owning reference to a callable that receives each Trade as it happens.
+  Matching hands fills straight to the caller's sink, so nothing is
+  allocated per call; a Trades vector, a TradeRing or any lambda can serve
+  as one. The referenced callable must outlive the call it is passed to*/
+class TradeSink
+{
+public:
+    template <typename Callable>
+        requires std::invocable<Callable&, const Trade&>
+              && (!std::same_as<std::remove_cvref_t<Callable>, TradeSink>)
+    TradeSink(Callable&& callable)
+        : target_{ const_cast<void*>(static_cast<const void*>(std::addressof(callable))) },
+          invoke_{ [](void* target, const Trade& trade)
+          {
+              (*static_cast<std::remove_reference_t<Callable>*>(target))(trade);
+          } }
+    { }
+
+    //Appends to trades, which keeps its capacity when reused across calls
+    TradeSink(Trades& trades)
+        : target_{ &trades },
+          invoke_{ [](void* target, const Trade& trade)
+          {
+              static_cast<Trades*>(target)->push_back(trade);
+          } }
+    { }
+
+    //A sink for callers that do not need the fills
+    static TradeSink Discard() { return TradeSink{ }; }
+
+    void operator()(const Trade& trade) const { invoke_(target_, trade); }
+
+private:
+    TradeSink()
+        : target_{ nullptr }, invoke_{ [](void*, const Trade&) { } }
+    { }
+
+    void* target_;
+    void (*invoke_)(void*, const Trade&);
+};
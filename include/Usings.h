@@ -1,8 +1,14 @@
 #pragma once 
 #include <vector>
-#include <optional>
+#include <cstdint>
 
-using Price = std::optional<std::int32_t>; 
+#include "FixedPrice.h"
+
+//Whole-number prices on a one unit tick, 4 bytes with no engaged flag
+using Price = FixedPrice<std::int32_t, 1, 0>; 
 using Quantity = std::uint32_t; 
 using OrderId = std::uint64_t; 
 using OrderIds = std::vector<OrderId>; 
+using OrderIndex = std::uint32_t; 
+
+using SymbolId = std::uint32_t; 
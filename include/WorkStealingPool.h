@@ -0,0 +1,71 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <condition_variable>
+
+#include "CacheLine.h"
+
+/*Runs independent tasks on a fixed set of threads, each owning a deque.
+  A thread takes its newest task first and, once its own deque is empty,
+  steals the oldest task of another thread, so a few long tasks never
+  leave the remaining cores idle. Tasks submitted from a pool thread go to
+  that thread's deque. Tasks must not throw*/
+class WorkStealingPool
+{
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct alignas(CacheLineSize) Worker
+        {
+            std::mutex mutex_;
+            std::deque<Task> tasks_;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        //Guards the counts below, sleeping threads wait on it
+        std::mutex mutex_;
+        std::condition_variable workConditionVariable_;
+        std::condition_variable idleConditionVariable_;
+        std::size_t queued_{ 0 };
+        std::size_t unfinished_{ 0 };
+        bool shutdown_{ false };
+
+        std::size_t nextWorker_{ 0 };
+        std::atomic<std::size_t> steals_{ 0 };
+
+        //Declared last so they start only once everything they use exists
+        std::vector<std::thread> threads_;
+
+        //Own newest task, else another thread's oldest
+        std::optional<Task> TryTake(std::size_t self);
+        void Run(std::size_t self);
+
+    public:
+
+        //Zero threads means one per core
+        explicit WorkStealingPool(std::size_t threadCount = 0);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        void operator=(const WorkStealingPool&) = delete;
+        WorkStealingPool(WorkStealingPool&&) = delete;
+        void operator=(WorkStealingPool&&) = delete;
+
+        void Submit(Task task);
+
+        //Blocks until every task submitted so far, and any they submitted, has run
+        void Wait();
+
+        std::size_t ThreadCount() const { return threads_.size(); }
+
+        //Tasks taken from another thread's deque so far
+        std::size_t Steals() const { return steals_.load(std::memory_order_relaxed); }
+};
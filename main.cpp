@@ -1,6 +1,41 @@
+#include "AsyncOrderbook.h"
 #include "Orderbook.h"
+#include "OrderbookManager.h"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
 #include <iostream>
 
+//Fire-and-forget coroutine, it runs until its first co_await and then on the executor
+struct DetachedClient 
+{ 
+    struct promise_type 
+    { 
+        DetachedClient get_return_object() { return { }; }
+        std::suspend_never initial_suspend() noexcept { return { }; }
+        std::suspend_never final_suspend() noexcept { return { }; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    }; 
+}; 
+
+/*One client quoting and pulling its quote in a loop. Each co_await waits 
+for that command's report, but many such clients keep the book busy*/
+DetachedClient RunClient(AsyncOrderbook& orderbook, std::size_t client, std::size_t rounds, std::atomic<std::size_t>& finished) 
+{ 
+    for (std::size_t round = 0; round < rounds; ++round)
+    { 
+        const OrderId orderId = (client << 32) | round; 
+        const auto side = client % 2 ? Side::Sell : Side::Buy; 
+        const Price price{ side == Side::Buy ? 99 : 101 }; 
+
+        co_await orderbook.Execute(Command::Add(0, Order{ OrderType::GoodTillCancel, orderId, side, price, 10 })); 
+        co_await orderbook.Execute(Command::Cancel(0, orderId)); 
+    }
+
+    finished.fetch_add(1, std::memory_order_release); 
+}
+
 int main() { 
     Orderbook orderbook; 
 
@@ -10,13 +45,43 @@ int main() {
         Ex.
         const OrderId orderId = 1; 
 
-        orderbook.AddOrder(std::make_shared<Order>
-            (OrderType::GoodTillCancel, orderId, Side::Buy, 100, 10)); 
+        orderbook.AddOrder(Order{ OrderType::GoodTillCancel, orderId, Side::Buy, Price{ 100 }, 10 }); 
         std::cout << "My current orderbook size: " << orderbook.Size() << std::endl; //1
 
         orderbook.CancelOrder(orderId); 
         std::cout << "Orderbook size after cancelling my order: " << orderbook.Size() << std::endl; //1
     */
 
+    /*  
+        Many instruments, each matched on the thread of its shard: 
+
+        OrderbookManager manager; 
+        const SymbolId symbolId = 7; 
+
+        manager.Submit(Command::Add(symbolId, Order{ OrderType::GoodTillCancel, orderId, Side::Buy, Price{ 100 }, 10 })); 
+        manager.Flush(); 
+        std::cout << "Symbol 7 size: " << manager.Size(symbolId) << std::endl; //1
+    */
+
+    //Coroutine clients pipelined on an AsyncOrderbook, 1000 requests in flight at once
+    { 
+        constexpr std::size_t Clients{ 1000 }; 
+        constexpr std::size_t Rounds{ 500 }; 
+
+        AsyncOrderbook asyncOrderbook; 
+        std::atomic<std::size_t> finished{ }; 
+
+        const auto start = std::chrono::steady_clock::now(); 
+        for (std::size_t client = 0; client < Clients; ++client)
+            RunClient(asyncOrderbook, client, Rounds, finished); 
+
+        while (finished.load(std::memory_order_acquire) < Clients)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); 
+
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); 
+        std::cout << "Async clients: " << Clients * Rounds * 2 / seconds / 1e6 
+                  << "M commands/s with " << Clients << " in flight" << std::endl; 
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+#include "AsyncOrderbook.h"
+
+#include <utility>
+
+AsyncOrderbook::AsyncOrderbook(const OrderbookConfig& config)
+    : book_{ config.SingleWriter() }
+{ 
+    //Registered before the executor starts, which reschedules it from then on
+    ScheduleSessionClose(); 
+    executor_ = std::thread{ [this]{ Run(); } }; 
+}
+
+AsyncOrderbook::~AsyncOrderbook() 
+{ 
+    { 
+        std::scoped_lock queueLock{ mutex_ }; 
+        shutdown_ = true; 
+    }
+    pendingConditionVariable_.notify_one(); 
+    executor_.join(); 
+
+    //Only the executor registers the wake-up, so this is the last one
+    book_.GetClock().Cancel(closeTask_); 
+}
+
+void AsyncOrderbook::Submit(const Command& command, Callback callback) 
+{ 
+    bool wasEmpty; 
+    { 
+        std::scoped_lock queueLock{ mutex_ }; 
+        wasEmpty = pending_.empty(); 
+        pending_.push_back(Request{ command, std::move(callback) }); 
+    }
+
+    //The executor only sleeps once it has drained the queue
+    if (wasEmpty)
+        pendingConditionVariable_.notify_one(); 
+}
+
+void AsyncOrderbook::Run() 
+{ 
+    std::vector<Request> batch; 
+
+    while (true)
+    { 
+        std::optional<std::size_t> queuedAtClose; 
+        { 
+            std::unique_lock queueLock{ mutex_ }; 
+            pendingConditionVariable_.wait(queueLock, [this]
+                { return shutdown_ || queuedAtClose_ || !pending_.empty(); }); 
+
+            if (pending_.empty() && !queuedAtClose_)
+                return; 
+
+            //Swapping keeps both vectors' capacity, so steady flow allocates nothing
+            queuedAtClose = std::exchange(queuedAtClose_, std::nullopt); 
+            batch.clear(); 
+            batch.swap(pending_); 
+        }
+
+        //Requests queued before the close are applied before it
+        const auto beforeClose = queuedAtClose.value_or(batch.size()); 
+        ApplyRequests(std::span{ batch }.first(beforeClose)); 
+        if (queuedAtClose)
+        { 
+            book_.PruneGoodForDayOrdersNow(); 
+            ScheduleSessionClose(); 
+        }
+        ApplyRequests(std::span{ batch }.subspan(beforeClose)); 
+    }
+}
+
+void AsyncOrderbook::ApplyRequests(std::span<Request> requests) 
+{ 
+    for (auto& request : requests)
+    { 
+        ExecutionReport report{ request.command_, false, Trades{ } }; 
+        report.applied_ = book_.Apply(request.command_, report.trades_); 
+
+        //May resume a coroutine, which can submit again before returning
+        if (request.callback_)
+            request.callback_(std::move(report)); 
+    }
+}
+
+void AsyncOrderbook::ScheduleSessionClose() 
+{ 
+    auto& clock = book_.GetClock(); 
+    closeTask_ = clock.ScheduleAt(Orderbook::NextSessionClose(clock.Now()), [this]
+    { 
+        { 
+            std::scoped_lock queueLock{ mutex_ }; 
+            queuedAtClose_ = pending_.size(); 
+        }
+        pendingConditionVariable_.notify_one(); 
+    }); 
+}
@@ -0,0 +1,144 @@
+#include "BinaryScenario.h"
+
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    //Two commands long, so commands stay aligned when the file is mapped
+    struct BinaryScenarioHeader
+    {
+        char magic_[8]{ 'O', 'B', 'S', 'C', 'E', 'N', 'A', 'R' };
+        std::uint32_t version_{ BinaryScenarioReader::Version };
+        std::uint32_t commandSize_{ sizeof(Command) };
+        std::uint64_t commandCount_{ };
+        std::uint64_t allCount_{ };
+        std::uint64_t bidCount_{ };
+        std::uint64_t askCount_{ };
+        std::uint8_t hasExpected_{ };
+        std::uint8_t reserved_[15]{ };
+    };
+
+    static_assert(sizeof(BinaryScenarioHeader) == 2 * sizeof(Command));
+
+    //Commands encoded per write call
+    constexpr std::size_t BlockSize{ 1 << 14 };
+
+    [[noreturn]] void ThrowError(int error, const std::string& what)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void WriteAll(int fd, const void* data, std::size_t size, const std::filesystem::path& path)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size)
+        {
+            const auto written = ::write(fd, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ThrowError(errno, "Cannot write binary scenario " + path.string());
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+}
+
+bool IsBinaryScenario(const std::filesystem::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    char magic[sizeof(BinaryScenarioHeader::magic_)]{ };
+    return file.read(magic, sizeof(magic))
+        && std::memcmp(magic, BinaryScenarioHeader{ }.magic_, sizeof(magic)) == 0;
+}
+
+void WriteBinaryScenario(const std::filesystem::path& path, ScenarioReader& reader)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        ThrowError(errno, "Cannot create binary scenario " + path.string());
+
+    try
+    {
+        //The counts are only known at the end, the header is rewritten then
+        BinaryScenarioHeader header;
+        WriteAll(fd, &header, sizeof(header), path);
+
+        std::vector<Command> block;
+        block.reserve(BlockSize);
+        for (const auto& command : reader)
+        {
+            //Copied over zeroes field by field, so padding never carries stray bytes into the file
+            auto& record = block.emplace_back();
+            std::memset(static_cast<void*>(&record), 0, sizeof(record));
+            record.kind_ = command.kind_;
+            record.orderType_ = command.orderType_;
+            record.side_ = command.side_;
+            record.symbolId_ = command.symbolId_;
+            record.orderId_ = command.orderId_;
+            record.price_ = command.price_;
+            record.quantity_ = command.quantity_;
+            if (block.size() == BlockSize)
+            {
+                WriteAll(fd, block.data(), block.size() * sizeof(Command), path);
+                header.commandCount_ += block.size();
+                block.clear();
+            }
+        }
+        WriteAll(fd, block.data(), block.size() * sizeof(Command), path);
+        header.commandCount_ += block.size();
+
+        if (const auto& expected = reader.Expected())
+        {
+            header.hasExpected_ = 1;
+            header.allCount_ = expected->allCount_;
+            header.bidCount_ = expected->bidCount_;
+            header.askCount_ = expected->askCount_;
+        }
+
+        if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+            ThrowError(errno, "Cannot write binary scenario " + path.string());
+    }
+    catch (...)
+    {
+        //Never leave a half written file that looks like a scenario
+        ::close(fd);
+        std::filesystem::remove(path);
+        throw;
+    }
+
+    ::close(fd);
+}
+
+BinaryScenarioReader::BinaryScenarioReader(const std::filesystem::path& path)
+    : file_{ path }
+{
+    const auto bytes = file_.Bytes();
+    if (bytes.size() < sizeof(BinaryScenarioHeader))
+        throw std::logic_error("Binary scenario too short: " + path.string());
+
+    BinaryScenarioHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic_, BinaryScenarioHeader{ }.magic_, sizeof(header.magic_)) != 0
+        || header.version_ != Version || header.commandSize_ != sizeof(Command))
+        throw std::logic_error("Not a version " + std::to_string(Version) + " binary scenario: " + path.string());
+
+    //Divides rather than multiplies, so a huge count cannot wrap into a match
+    const auto payload = bytes.size() - sizeof(header);
+    if (payload % sizeof(Command) || header.commandCount_ != payload / sizeof(Command))
+        throw std::logic_error("Binary scenario size does not match its command count: " + path.string());
+
+    commands_ = { reinterpret_cast<const Command*>(bytes.data() + sizeof(header)), header.commandCount_ };
+    if (header.hasExpected_)
+        expected_ = ScenarioResult{ header.allCount_, header.bidCount_, header.askCount_ };
+}
@@ -0,0 +1,224 @@
+#include "CommandJournal.h"
+
+#include <span>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "MappedFile.h"
+#include "Orderbook.h"
+
+namespace
+{
+    //Same size as a record, so records stay aligned when the file is mapped
+    struct JournalHeader
+    {
+        char magic_[8]{ 'O', 'B', 'J', 'O', 'U', 'R', 'N', 'L' };
+        std::uint32_t version_{ CommandJournal::Version };
+        std::uint32_t recordSize_{ sizeof(JournalRecord) };
+        std::uint8_t reserved_[24]{ };
+    };
+
+    static_assert(sizeof(JournalHeader) == sizeof(JournalRecord));
+
+    [[noreturn]] void ThrowError(int error, const std::string& what)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    //Retries short and interrupted writes, returning errno or zero
+    int WriteAll(int fd, const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size)
+        {
+            const auto written = ::write(fd, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return errno;
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return 0;
+    }
+
+    //A new file is only durable once the directory entry naming it is
+    void SyncDirectory(const std::filesystem::path& path)
+    {
+        const auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path{ "." };
+        const int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+CommandJournal::CommandJournal(const std::filesystem::path& path)
+    : path_{ path }
+{
+    try
+    {
+        Open();
+    }
+    catch (...)
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+        throw;
+    }
+
+    thread_ = std::thread{ [this]{ Run(); } };
+}
+
+CommandJournal::~CommandJournal()
+{
+    {
+        std::scoped_lock journalLock{ mutex_ };
+        shutdown_ = true;
+    }
+    pendingConditionVariable_.notify_one();
+    thread_.join();
+
+    ::close(fd_);
+}
+
+void CommandJournal::Open()
+{
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+        ThrowError(errno, "Cannot open journal " + path_.string());
+
+    struct stat status;
+    if (::fstat(fd_, &status) != 0)
+        ThrowError(errno, "Cannot stat journal " + path_.string());
+
+    //A crash while the header was being written leaves nothing worth keeping
+    if (static_cast<std::size_t>(status.st_size) < sizeof(JournalHeader))
+    {
+        const JournalHeader header;
+        if (::ftruncate(fd_, 0) != 0 || WriteAll(fd_, &header, sizeof(header)) != 0 || ::fsync(fd_) != 0)
+            ThrowError(errno, "Cannot create journal " + path_.string());
+
+        SyncDirectory(path_);
+        return;
+    }
+
+    const MappedFile file{ path_ };
+    const auto bytes = file.Bytes();
+
+    JournalHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic_, JournalHeader{ }.magic_, sizeof(header.magic_)) != 0
+        || header.version_ != Version || header.recordSize_ != sizeof(JournalRecord))
+        throw std::logic_error("Not a version " + std::to_string(Version) + " journal: " + path_.string());
+
+    const std::span records{ reinterpret_cast<const JournalRecord*>(bytes.data() + sizeof(header)),
+        (bytes.size() - sizeof(header)) / sizeof(JournalRecord) };
+
+    //Records are consecutive, the first gap or zeroed block marks the end of what was written
+    std::uint64_t validRecords{ 0 };
+    while (validRecords < records.size() && records[validRecords].sequence_ != 0
+        && (validRecords == 0 || records[validRecords].sequence_ == records[validRecords - 1].sequence_ + 1))
+        ++validRecords;
+
+    recordsAtOpen_ = validRecords;
+    lastAppended_ = validRecords ? records[validRecords - 1].sequence_ : 0;
+    durable_.store(lastAppended_, std::memory_order_release);
+
+    const auto validSize = sizeof(header) + validRecords * sizeof(JournalRecord);
+    if (validSize != bytes.size())
+    {
+        if (::ftruncate(fd_, static_cast<off_t>(validSize)) != 0 || ::fsync(fd_) != 0)
+            ThrowError(errno, "Cannot trim journal " + path_.string());
+    }
+}
+
+void CommandJournal::Append(const JournalRecord& record)
+{
+    bool wasEmpty;
+    {
+        std::scoped_lock journalLock{ mutex_ };
+
+        //An empty journal may start anywhere, such as just after a snapshot
+        if (record.sequence_ == 0 || (lastAppended_ && record.sequence_ != lastAppended_ + 1))
+            throw std::logic_error("Journal record " + std::to_string(record.sequence_) + " does not follow "
+                + std::to_string(lastAppended_) + " in " + path_.string());
+
+        lastAppended_ = record.sequence_;
+        wasEmpty = pending_.empty();
+        pending_.push_back(record);
+    }
+
+    //A busy writer picks the record up with its next batch
+    if (wasEmpty)
+        pendingConditionVariable_.notify_one();
+}
+
+void CommandJournal::WaitDurable(std::uint64_t sequence) const
+{
+    std::unique_lock journalLock{ mutex_ };
+    durableConditionVariable_.wait(journalLock, [this, sequence]
+    {
+        return error_ || durable_.load(std::memory_order_relaxed) >= sequence;
+    });
+
+    if (error_)
+        ThrowError(error_, "Journal write failed for " + path_.string());
+}
+
+void CommandJournal::Run()
+{
+    std::vector<JournalRecord> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock journalLock{ mutex_ };
+            pendingConditionVariable_.wait(journalLock, [this]{ return shutdown_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+
+            //Swapping keeps both buffers' capacity, so steady appends allocate nothing
+            std::swap(batch, pending_);
+        }
+
+        int error = WriteAll(fd_, batch.data(), batch.size() * sizeof(JournalRecord));
+        if (!error && ::fsync(fd_) != 0)
+            error = errno;
+
+        {
+            std::scoped_lock journalLock{ mutex_ };
+            if (error)
+                error_ = error;
+            else
+                durable_.store(batch.back().sequence_, std::memory_order_release);
+        }
+        durableConditionVariable_.notify_all();
+
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        batch.clear();
+    }
+}
+
+std::uint64_t CommandJournal::Recover(Orderbook& book) const
+{
+    if (!recordsAtOpen_)
+        return book.LastSequence();
+
+    const MappedFile file{ path_ };
+    const std::span records{ reinterpret_cast<const JournalRecord*>(file.Bytes().data() + sizeof(JournalHeader)),
+        recordsAtOpen_ };
+
+    book.Replay(records);
+    return book.LastSequence();
+}
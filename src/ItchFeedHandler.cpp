@@ -0,0 +1,334 @@
+#include "ItchFeedHandler.h"
+
+#include <limits>
+#include <format>
+#include <algorithm>
+#include <stdexcept>
+
+#include "MappedFile.h"
+
+namespace
+{
+    //Every message starts with its type, stock locate, tracking number and timestamp
+    constexpr std::size_t LocateOffset{ 1 };
+    constexpr std::size_t BodyOffset{ 11 };
+
+    constexpr std::size_t StockDirectoryLength{ 39 };
+    constexpr std::size_t AddOrderLength{ 36 };
+    constexpr std::size_t AddAttributedOrderLength{ 40 };
+    constexpr std::size_t ExecuteLength{ 31 };
+    constexpr std::size_t CancelLength{ 23 };
+    constexpr std::size_t DeleteLength{ 19 };
+    constexpr std::size_t ReplaceLength{ 35 };
+
+    //Shortest body each handled type may have, zero for types that are skipped
+    constexpr std::size_t LengthOf(char type)
+    {
+        switch (type)
+        {
+        case 'R': return StockDirectoryLength;
+        case 'A': return AddOrderLength;
+        case 'F': return AddAttributedOrderLength;
+        case 'E': return ExecuteLength;
+        case 'X': return CancelLength;
+        case 'D': return DeleteLength;
+        case 'U': return ReplaceLength;
+        default: return 0;
+        }
+    }
+
+    template <typename Value>
+    Value ReadBigEndian(const std::byte* data)
+    {
+        Value value{ };
+        for (std::size_t index = 0; index < sizeof(Value); ++index)
+            value = static_cast<Value>(value << 8 | std::to_integer<Value>(data[index]));
+        return value;
+    }
+
+    template <typename Value>
+    void WriteBigEndian(std::byte* data, Value value)
+    {
+        for (std::size_t index = sizeof(Value); index-- > 0; value = static_cast<Value>(value >> 8))
+            data[index] = static_cast<std::byte>(value & 0xFF);
+    }
+
+    //Space padded on the right, as ITCH alphanumeric fields are
+    void WriteAlpha(std::byte* data, std::string_view text, std::size_t length)
+    {
+        for (std::size_t index = 0; index < length; ++index)
+            data[index] = static_cast<std::byte>(index < text.size() ? text[index] : ' ');
+    }
+}
+
+std::byte* ItchCaptureWriter::Append(char type, std::uint16_t locate, std::size_t length)
+{
+    const auto start = bytes_.size();
+    bytes_.resize(start + 2 + length);
+
+    auto* message = bytes_.data() + start;
+    WriteBigEndian(message, static_cast<std::uint16_t>(length));
+    message += 2;
+    message[0] = static_cast<std::byte>(type);
+    WriteBigEndian(message + LocateOffset, locate);
+    return message;
+}
+
+void ItchCaptureWriter::StockDirectory(std::uint16_t locate, std::string_view symbol)
+{
+    auto* message = Append('R', locate, StockDirectoryLength);
+    WriteAlpha(message + BodyOffset, symbol, 8);
+}
+
+void ItchCaptureWriter::AddOrder(std::uint16_t locate, std::uint64_t orderRef, Side side,
+    std::uint32_t shares, std::uint32_t price)
+{
+    auto* message = Append('A', locate, AddOrderLength);
+    WriteBigEndian(message + 11, orderRef);
+    message[19] = static_cast<std::byte>(side == Side::Buy ? 'B' : 'S');
+    WriteBigEndian(message + 20, shares);
+    WriteAlpha(message + 24, { }, 8);
+    WriteBigEndian(message + 32, price);
+}
+
+void ItchCaptureWriter::AddAttributedOrder(std::uint16_t locate, std::uint64_t orderRef, Side side,
+    std::uint32_t shares, std::uint32_t price, std::string_view attribution)
+{
+    auto* message = Append('F', locate, AddAttributedOrderLength);
+    WriteBigEndian(message + 11, orderRef);
+    message[19] = static_cast<std::byte>(side == Side::Buy ? 'B' : 'S');
+    WriteBigEndian(message + 20, shares);
+    WriteAlpha(message + 24, { }, 8);
+    WriteBigEndian(message + 32, price);
+    WriteAlpha(message + 36, attribution, 4);
+}
+
+void ItchCaptureWriter::Execute(std::uint16_t locate, std::uint64_t orderRef, std::uint32_t shares,
+    std::uint64_t matchNumber)
+{
+    auto* message = Append('E', locate, ExecuteLength);
+    WriteBigEndian(message + 11, orderRef);
+    WriteBigEndian(message + 19, shares);
+    WriteBigEndian(message + 23, matchNumber);
+}
+
+void ItchCaptureWriter::Cancel(std::uint16_t locate, std::uint64_t orderRef, std::uint32_t shares)
+{
+    auto* message = Append('X', locate, CancelLength);
+    WriteBigEndian(message + 11, orderRef);
+    WriteBigEndian(message + 19, shares);
+}
+
+void ItchCaptureWriter::Delete(std::uint16_t locate, std::uint64_t orderRef)
+{
+    auto* message = Append('D', locate, DeleteLength);
+    WriteBigEndian(message + 11, orderRef);
+}
+
+void ItchCaptureWriter::Replace(std::uint16_t locate, std::uint64_t orderRef, std::uint64_t newOrderRef,
+    std::uint32_t shares, std::uint32_t price)
+{
+    auto* message = Append('U', locate, ReplaceLength);
+    WriteBigEndian(message + 11, orderRef);
+    WriteBigEndian(message + 19, newOrderRef);
+    WriteBigEndian(message + 27, shares);
+    WriteBigEndian(message + 31, price);
+}
+
+ItchFeedHandler::ItchFeedHandler(const OrderbookConfig& bookConfig, std::uint32_t priceUnitsPerTick,
+    std::size_t expectedOrders)
+    : bookConfig_{ bookConfig.SingleWriter() }, priceUnitsPerTick_{ std::max<std::uint32_t>(priceUnitsPerTick, 1) },
+      orders_{ OrderIdIndex<FeedOrder>::Mode::Hashed, expectedOrders }
+{
+    bookConfig_.mirror_ = true;
+}
+
+ItchFeedHandler::Book& ItchFeedHandler::BookFor(std::uint16_t locate)
+{
+    if (locate >= books_.size())
+        books_.resize(static_cast<std::size_t>(locate) + 1);
+    return books_[locate];
+}
+
+void ItchFeedHandler::Queue(std::uint16_t locate, const Command& command)
+{
+    auto& book = BookFor(locate);
+    if (!book.orderbook_)
+        book.orderbook_ = std::make_unique<Orderbook>(bookConfig_);
+
+    if (book.pending_.empty())
+        pendingLocates_.push_back(locate);
+    book.pending_.push_back(command);
+}
+
+//No price for one off the tick grid or beyond what Price holds
+Price ItchFeedHandler::ToPrice(std::uint32_t feedPrice) const
+{
+    const auto ticks = feedPrice / priceUnitsPerTick_;
+    if (ticks * priceUnitsPerTick_ != feedPrice
+        || ticks > static_cast<std::uint32_t>(std::numeric_limits<Price::Representation>::max()))
+        return Price::None();
+    return Price{ static_cast<Price::Representation>(ticks) };
+}
+
+//What is left of the order stays at its place in the queue
+void ItchFeedHandler::Reduce(std::uint16_t locate, OrderId orderRef, Quantity shares)
+{
+    auto* order = orders_.Find(orderRef);
+    if (!order)
+    {
+        ++stats_.unknownOrders_;
+        return;
+    }
+
+    if (shares >= order->quantity_)
+    {
+        orders_.Erase(orderRef);
+        Queue(locate, Command::Cancel(locate, orderRef));
+        return;
+    }
+
+    order->quantity_ -= shares;
+    Queue(locate, Command::Modify(locate, OrderModify{ orderRef, order->side_, order->price_, order->quantity_ }));
+}
+
+void ItchFeedHandler::Decode(std::span<const std::byte> message)
+{
+    ++stats_.messages_;
+
+    const auto type = message.empty() ? '\0' : static_cast<char>(message[0]);
+    const auto length = LengthOf(type);
+    if (!length)
+    {
+        ++stats_.skipped_;
+        return;
+    }
+    if (message.size() < length)
+        throw std::logic_error(std::format("ITCH {} message of {} bytes is too short", type, message.size()));
+
+    const auto* data = message.data();
+    const auto locate = ReadBigEndian<std::uint16_t>(data + LocateOffset);
+    const auto orderRef = ReadBigEndian<std::uint64_t>(data + BodyOffset);
+
+    switch (type)
+    {
+    case 'R':
+    {
+        auto& symbol = BookFor(locate).symbol_;
+        std::transform(data + BodyOffset, data + BodyOffset + symbol.size(), symbol.begin(),
+            [](std::byte character) { return static_cast<char>(character); });
+        return;
+    }
+    case 'A':
+    case 'F':
+    {
+        const auto side = static_cast<char>(data[19]) == 'B' ? Side::Buy : Side::Sell;
+        const auto shares = ReadBigEndian<std::uint32_t>(data + 20);
+        const auto price = ToPrice(ReadBigEndian<std::uint32_t>(data + 32));
+
+        if (!price.HasValue() || !shares || !orders_.Insert(orderRef, FeedOrder{ side, price, shares }))
+        {
+            ++stats_.skipped_;
+            return;
+        }
+
+        ++stats_.adds_;
+        Queue(locate, Command{ Command::Kind::Add, OrderType::GoodTillCancel, side, locate, orderRef, price, shares });
+        return;
+    }
+    case 'E':
+        ++stats_.executions_;
+        Reduce(locate, orderRef, ReadBigEndian<std::uint32_t>(data + 19));
+        return;
+    case 'X':
+        ++stats_.cancels_;
+        Reduce(locate, orderRef, ReadBigEndian<std::uint32_t>(data + 19));
+        return;
+    case 'D':
+        ++stats_.deletes_;
+        if (orders_.Erase(orderRef))
+            Queue(locate, Command::Cancel(locate, orderRef));
+        else
+            ++stats_.unknownOrders_;
+        return;
+    case 'U':
+    {
+        ++stats_.replaces_;
+        const auto order = orders_.Extract(orderRef);
+        if (!order)
+        {
+            ++stats_.unknownOrders_;
+            return;
+        }
+        Queue(locate, Command::Cancel(locate, orderRef));
+
+        //The new reference keeps the side and joins the back of its level
+        const auto newOrderRef = ReadBigEndian<std::uint64_t>(data + 19);
+        const auto shares = ReadBigEndian<std::uint32_t>(data + 27);
+        const auto price = ToPrice(ReadBigEndian<std::uint32_t>(data + 31));
+        if (!price.HasValue() || !shares || !orders_.Insert(newOrderRef, FeedOrder{ order->side_, price, shares }))
+        {
+            ++stats_.skipped_;
+            return;
+        }
+        Queue(locate, Command{ Command::Kind::Add, OrderType::GoodTillCancel, order->side_, locate, newOrderRef, price, shares });
+        return;
+    }
+    }
+}
+
+void ItchFeedHandler::FlushPending()
+{
+    for (const auto locate : pendingLocates_)
+    {
+        auto& book = books_[locate];
+        book.orderbook_->Submit(book.pending_, TradeSink::Discard());
+        book.pending_.clear();
+    }
+    pendingLocates_.clear();
+}
+
+std::size_t ItchFeedHandler::Process(std::span<const std::byte> capture)
+{
+    std::size_t offset{ 0 }, decoded{ 0 };
+    while (offset + 2 <= capture.size())
+    {
+        const auto length = ReadBigEndian<std::uint16_t>(capture.data() + offset);
+        if (offset + 2 + length > capture.size())
+            break;
+
+        Decode(capture.subspan(offset + 2, length));
+        offset += 2 + length;
+
+        if (++decoded == ChunkSize)
+        {
+            FlushPending();
+            decoded = 0;
+        }
+    }
+
+    FlushPending();
+    return offset;
+}
+
+std::size_t ItchFeedHandler::ProcessFile(const std::filesystem::path& path)
+{
+    const MappedFile file{ path };
+    return Process(file.Bytes());
+}
+
+const Orderbook* ItchFeedHandler::GetOrderbook(std::uint16_t locate) const
+{
+    return locate < books_.size() ? books_[locate].orderbook_.get() : nullptr;
+}
+
+std::string_view ItchFeedHandler::Symbol(std::uint16_t locate) const
+{
+    if (locate >= books_.size())
+        return { };
+
+    const auto& symbol = books_[locate].symbol_;
+    std::string_view name{ symbol.data(), symbol.size() };
+    const auto end = name.find_last_not_of(std::string_view{ " \0", 2 });
+    return end == std::string_view::npos ? std::string_view{ } : name.substr(0, end + 1);
+}
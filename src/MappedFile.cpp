@@ -0,0 +1,49 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path.string());
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "Cannot stat " + path.string());
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_)
+    {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Cannot map " + path.string());
+        }
+
+        //Read front to back, so let the kernel read ahead aggressively
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const std::byte*>(mapping);
+    }
+
+    //The mapping stays valid once the descriptor is closed
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<std::byte*>(data_), size_);
+}
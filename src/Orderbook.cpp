@@ -1,149 +1,219 @@
 #include "Orderbook.h"
 
+#include <array>
 #include <ctime>
+#include <algorithm>
 #include <chrono>
 
-void Orderbook::PruneGoodForDayOrders()
+#include "CommandJournal.h"
+
+std::chrono::system_clock::time_point Orderbook::NextSessionClose(
+    std::chrono::system_clock::time_point now)
 { 
     using namespace std::chrono;
     //4 PM Pruning
     const auto end = hours(16); 
 
-    while (true) 
-    { 
-        const auto now = system_clock::now(); 
-        const auto now_c = system_clock::to_time_t(now); 
-        std::tm now_parts;
-        localtime_r(&now_c, &now_parts);
-
-        //If already past 4 PM, increment prune time to tomorrow
-        if (now_parts.tm_hour >= end.count())
-            now_parts.tm_mday += 1;
-
-        //Set prune hour to 4 PM
-        now_parts.tm_hour = end.count();
-        now_parts.tm_min = 0;
-        now_parts.tm_sec = 0;
-        
-        //Calculate time to sleep with some delay
-        auto next = system_clock::from_time_t(mktime(&now_parts));
-        auto till = next - now + milliseconds(100);    
+    const auto now_c = system_clock::to_time_t(now); 
+    std::tm now_parts;
+    localtime_r(&now_c, &now_parts);
 
-        { 
-            std::unique_lock ordersLock{ ordersMutex_ }; 
+    //If already past 4 PM, increment prune time to tomorrow
+    if (now_parts.tm_hour >= end.count())
+        now_parts.tm_mday += 1;
 
-            //If orderbook is shutdown prematurely
-            if (shutdown_.load(std::memory_order_acquire) || 
-                shutdownConditionVariable_.wait_for(ordersLock, till) == std::cv_status::no_timeout)
-                    return;
-        }
+    //Set prune hour to 4 PM
+    now_parts.tm_hour = end.count();
+    now_parts.tm_min = 0;
+    now_parts.tm_sec = 0;
+    
+    return system_clock::from_time_t(mktime(&now_parts));
+}
 
-        OrderIds orderIds; 
-        { 
-            std::scoped_lock ordersLock{ ordersMutex_ }; 
+void Orderbook::PruneGoodForDayOrdersNow()
+{ 
+    //GoodForDay orders entered while expiry is under way expire too
+    while (true)
+    { 
+        auto ordersLock = LockOrders(); 
+        if (goodForDayOrders_.Empty())
+            return; 
 
-            for (const auto& [_, orderEntry] : orders_) 
-            {
-                const auto& order = orderEntry.order_;  
-                if (order->GetOrderType() == OrderType::Market)
-                    orderIds.push_back(order->GetOrderId()); 
-            }
+        ExpireChunk(); 
+    }
+}
+
+void Orderbook::OnSessionClose()
+{ 
+    while (true)
+    { 
+        auto ordersLock = LockOrders(); 
+        if (goodForDayOrders_.Empty())
+        { 
+            expiryTask_ = Clock::NoTask; 
+            return; 
         }
 
-        CancelOrders(orderIds); 
+        ExpireChunk(); 
     }
-
 }
 
-void Orderbook::CancelOrders(OrderIds orderIds)
+void Orderbook::ExpireChunk()
 { 
-    std::scoped_lock ordersLock{ ordersMutex_ }; 
+    for (std::size_t expired = 0; expired < expiryChunkSize_ && !goodForDayOrders_.Empty(); ++expired)
+    { 
+        const auto orderId = pool_[goodForDayOrders_.Front()].GetOrderId(); 
+        CancelOrderInternal(orderId); 
+        Record(Command::Cancel(0, orderId)); 
+    }
 
-    for (OrderId orderId: orderIds) 
-        CancelOrderInternal(orderId);
+    PublishSnapshot(); 
 }
 
-void Orderbook::CancelOrderInternal(OrderId orderId) 
+void Orderbook::ScheduleExpiry()
 { 
-    if (!orders_.contains(orderId))
+    if (singleWriter_ || expiryTask_ != Clock::NoTask)
         return; 
 
-    const auto& [order, orderLocation] = orders_[orderId];  
+    //Woken with some delay past the close
+    const auto close = NextSessionClose(clock_.Now()) + std::chrono::milliseconds(100); 
+    expiryTask_ = clock_.ScheduleAt(close, [this]{ OnSessionClose(); }); 
+}
 
-    if (order->GetSide() == Side::Buy) 
+std::unique_lock<std::mutex> Orderbook::LockOrders() const 
+{ 
+    return singleWriter_ ? std::unique_lock<std::mutex>{ } : std::unique_lock{ ordersMutex_ }; 
+}
+
+bool Orderbook::CancelOrderInternal(OrderId orderId) 
+{ 
+    //Single probe to both find and unlink the entry
+    const auto orderEntry = orders_.Extract(orderId); 
+    if (!orderEntry)
+        return false; 
+
+    const auto orderLocation = orderEntry->location_;  
+    UnlinkOrder(orderLocation, pool_[orderLocation]); 
+    ReleaseOrder(orderLocation); 
+    return true; 
+}
+
+bool Orderbook::RestOrder(const Order& order) 
+{ 
+    const auto location = pool_.Acquire(order); 
+    if (!orders_.Insert(order.GetOrderId(), OrderEntry { location }))
     { 
-        auto& ordersAtPrice = bids_[order->GetPrice()]; 
-        ordersAtPrice.erase(orderLocation); 
-        if (ordersAtPrice.empty())
-            bids_.erase(order->GetPrice()); 
-    }  
-    else 
+        pool_.Release(location); 
+        return false; 
+    }
+    LinkOrder(location, order); 
+
+    if (order.GetOrderType() == OrderType::GoodForDay)
     { 
-        auto& ordersAtPrice = asks_[order->GetPrice()]; 
-        ordersAtPrice.erase(orderLocation); 
-        if (ordersAtPrice.empty())
-            asks_.erase(order->GetPrice()); 
+        goodForDayOrders_.PushBack(pool_, location); 
+        ScheduleExpiry(); 
     }
+    return true; 
+}
 
-    OnOrderCancelled(order); 
-    
-    orders_.erase(orderId); 
+void Orderbook::LinkOrder(OrderIndex location, const Order& order) 
+{ 
+    auto& level = order.GetSide() == Side::Buy 
+        ? bids_.GetOrCreateLevel(order.GetPrice()) 
+        : asks_.GetOrCreateLevel(order.GetPrice()); 
+
+    level.orders_.PushBack(pool_, location); 
+    OnOrderAdded(level, order); 
 }
 
-void Orderbook::OnOrderAdded(OrderPointer order)
+void Orderbook::UnlinkOrder(OrderIndex location, const Order& order) 
 { 
-    UpdateLevelData(order->GetPrice(), order->GetInitialQuantity(), LevelData::Action::Add); 
+    auto& level = order.GetSide() == Side::Buy 
+        ? *bids_.FindLevel(order.GetPrice()) 
+        : *asks_.FindLevel(order.GetPrice()); 
+
+    level.orders_.Erase(pool_, location); 
+    OnOrderCancelled(level, order); 
+
+    //Aggregates are updated first, as erasing may free the level
+    if (level.Empty())
+    { 
+        if (order.GetSide() == Side::Buy) 
+            bids_.EraseLevel(order.GetPrice()); 
+        else 
+            asks_.EraseLevel(order.GetPrice()); 
+    }
 }
 
+void Orderbook::ReleaseOrder(OrderIndex location) 
+{ 
+    if (pool_[location].GetOrderType() == OrderType::GoodForDay)
+        goodForDayOrders_.Erase(pool_, location); 
+
+    pool_.Release(location); 
+}
 
-void Orderbook::OnOrderCancelled(OrderPointer order)
+void Orderbook::OnOrderAdded(PriceLevel& level, const Order& order)
 { 
-    UpdateLevelData(order->GetPrice(), order->GetRemainingQuantity(), LevelData::Action::Remove); 
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), order.GetRemainingQuantity(), PriceLevel::Action::Add); 
 }
 
 
-void Orderbook::OnOrderMatched(Price price, Quantity quantity, 
-    bool isFullyFilled)
+void Orderbook::OnOrderCancelled(PriceLevel& level, const Order& order)
 { 
-    UpdateLevelData(price, quantity, isFullyFilled ? LevelData::Action::Remove : LevelData::Action::Match); 
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), order.GetRemainingQuantity(), PriceLevel::Action::Remove); 
 }
 
-void Orderbook::UpdateLevelData(Price price, Quantity quantity, LevelData::Action action) 
+
+void Orderbook::OnOrderMatched(PriceLevel& level, const Order& order, Quantity quantity)
+{ 
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), quantity, 
+        order.IsFilled() ? PriceLevel::Action::Remove : PriceLevel::Action::Match); 
+}
+
+void Orderbook::UpdateLevelData(PriceLevel& level, Side side, Price price, 
+    Quantity quantity, PriceLevel::Action action) 
 { 
-    auto& data = data_[price]; 
-    if (action == LevelData::Action::Remove)
+    if (action == PriceLevel::Action::Remove)
     {
-        data.orderCount_ -= 1; 
-        data.quantity_ -= quantity; 
+        level.orderCount_ -= 1; 
+        level.quantity_ -= quantity; 
     }
-    else if (action == LevelData::Action::Add)
+    else if (action == PriceLevel::Action::Add)
     {
-        data.orderCount_ += 1; 
-        data.quantity_ += quantity; 
+        level.orderCount_ += 1; 
+        level.quantity_ += quantity; 
     } 
     else 
-        data.quantity_ -= quantity; 
+        level.quantity_ -= quantity; 
 
-    if (!data.orderCount_)
-        data_.erase(price);
+    //Keeps the ladder's cumulative depth in step for FillOrKill checks
+    const auto delta = action == PriceLevel::Action::Add 
+        ? static_cast<std::int64_t>(quantity) : -static_cast<std::int64_t>(quantity); 
+    if (side == Side::Buy)
+        bids_.AddDepth(price, delta); 
+    else 
+        asks_.AddDepth(price, delta); 
 }
 
 bool Orderbook::CanMatch(Side side, Price price) const 
 { 
+    //A mirror book shows the venue's orders, the venue does the matching
+    if (mirror_)
+        return false; 
+
     if (side == Side::Buy) { 
-        if (asks_.empty())
+        if (asks_.Empty())
             return false; 
         
-        const auto& [bestAsk, _] = *asks_.begin(); 
-        return price >= bestAsk;   
+        return price >= asks_.BestPrice();   
     }
     else 
     { 
-        if (bids_.empty())
+        if (bids_.Empty())
             return false; 
         
-        const auto& [bestBid, _] = *bids_.begin(); 
-        return price <= bestBid;    
+        return price <= bids_.BestPrice();    
     }
  }
 
@@ -152,186 +222,251 @@ bool Orderbook::CanMatch(Side side, Price price) const
     if (!CanMatch(side, price))
         return false; 
 
-    Price thresholdPrice; 
-
+    //Opposite side's quantity at prices up to and including the limit
     if (side == Side::Buy)
-    {
-        const auto& [bestAskPrice, _] = *asks_.begin(); 
-        thresholdPrice = bestAskPrice; 
-    }
+        return asks_.HasDepth(price, quantity); 
     else 
-    { 
-        const auto& [bestBidPrice, _] = *bids_.begin(); 
-        thresholdPrice = bestBidPrice; 
-    }
-
-    for (const auto& [levelPrice, levelData] : data_)
-    { 
-        if ((side == Side::Buy &&
-            levelPrice >= thresholdPrice && levelPrice <= price) || 
-            (side == Side::Sell &&
-            levelPrice <= thresholdPrice && levelPrice >= price))
-            {
-                if (quantity <= levelData.quantity_)
-                    return true; 
-
-                quantity -= levelData.quantity_; 
-            }
-    }
-    return false; 
+        return bids_.HasDepth(price, quantity); 
  }
 
-Trades Orderbook::MatchOrders()
+void Orderbook::MatchOrders(TradeSink sink)
 {  
-    Trades trades; 
-    trades.reserve(orders_.size()); 
 
     while (true) {
-        if (bids_.empty() || asks_.empty())
+        if (bids_.Empty() || asks_.Empty())
             break; 
-        auto& [bidPrice, bids] = *bids_.begin(); 
-        auto& [askPrice, asks] = *asks_.begin(); 
+        const auto bidPrice = bids_.BestPrice(); 
+        const auto askPrice = asks_.BestPrice(); 
 
         if (bidPrice < askPrice)
             break; 
-        
-        while (bids.size() && asks.size()) {
-            auto bid = bids.front(); 
-            auto ask = asks.front(); 
 
-            Quantity quantity = std::min(bid->GetRemainingQuantity(), 
-            ask->GetRemainingQuantity()); 
+        auto& bids = bids_.BestLevel(); 
+        auto& asks = asks_.BestLevel(); 
+        
+        while (!bids.Empty() && !asks.Empty()) {
+            const auto bidLocation = bids.orders_.Front(); 
+            const auto askLocation = asks.orders_.Front(); 
+            auto& bid = pool_[bidLocation]; 
+            auto& ask = pool_[askLocation]; 
 
-            bid->Fill(quantity); 
-            ask->Fill(quantity); 
+            Quantity quantity = std::min(bid.GetRemainingQuantity(), 
+            ask.GetRemainingQuantity()); 
 
-            if (bid->IsFilled()) { 
-                bids.pop_front(); 
-                orders_.erase(bid->GetOrderId()); 
-            }
+            bid.Fill(quantity); 
+            ask.Fill(quantity); 
 
-            if (ask->IsFilled()) { 
-                asks.pop_front(); 
-                orders_.erase(ask->GetOrderId()); 
-            }
-
-            trades.push_back(Trade{ 
+            sink(Trade{ 
                 TradeInfo {
-                    bid->GetOrderId(), bid->GetPrice(), quantity
+                    bid.GetOrderId(), bid.GetPrice(), quantity
                 }, 
                 TradeInfo{
-                    ask->GetOrderId(), ask->GetPrice(), quantity, 
+                    ask.GetOrderId(), ask.GetPrice(), quantity, 
                 }
             }); 
 
-            OnOrderMatched(bid->GetPrice(), quantity, bid->IsFilled()); 
-            OnOrderMatched(ask->GetPrice(), quantity, ask->IsFilled()); 
-        }
+            OnOrderMatched(bids, bid, quantity); 
+            OnOrderMatched(asks, ask, quantity); 
 
-        if (bids.empty())
-        {
-            bids_.erase(bidPrice);
-            data_.erase(bidPrice);
-        }
+            //Slots are released last, as a released slot may be reused
+            if (bid.IsFilled()) { 
+                bids.orders_.PopFront(pool_); 
+                orders_.Erase(bid.GetOrderId()); 
+                ReleaseOrder(bidLocation); 
+            }
 
-        if (asks.empty())
-        {
-            asks_.erase(askPrice);
-            data_.erase(askPrice);
+            if (ask.IsFilled()) { 
+                asks.orders_.PopFront(pool_); 
+                orders_.Erase(ask.GetOrderId()); 
+                ReleaseOrder(askLocation); 
+            }
         }
+
+        if (bids.Empty())
+            bids_.EraseLevel(bidPrice);
+
+        if (asks.Empty())
+            asks_.EraseLevel(askPrice);
     }
 
-    if (!bids_.empty()) 
+    /*Called with ordersMutex_ already held, so the leftover FillAndKill 
+    order is removed through CancelOrderInternal*/
+    if (!bids_.Empty()) 
     { 
-        auto& [_, bids] = *bids_.begin(); 
-        auto& order =  bids.front(); 
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrder(order->GetOrderId()); 
+        const auto& order = pool_[bids_.BestLevel().orders_.Front()]; 
+        if (order.GetOrderType() == OrderType::FillAndKill)
+            CancelOrderInternal(order.GetOrderId()); 
     }
 
-    if (!asks_.empty()) 
+    if (!asks_.Empty()) 
     { 
-        auto& [_, asks] = *asks_.begin(); 
-        auto& order =  asks.front(); 
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrder(order->GetOrderId()); 
+        const auto& order = pool_[asks_.BestLevel().orders_.Front()]; 
+        if (order.GetOrderType() == OrderType::FillAndKill)
+            CancelOrderInternal(order.GetOrderId()); 
+    }
+}
+
+template <typename Ladder>
+void Orderbook::SweepLevels(Order& order, Ladder& ladder, TradeSink sink)
+{ 
+    const auto protection = order.GetPrice(); 
+    std::size_t levelsSwept{ }; 
+
+    while (!order.IsFilled() && !ladder.Empty())
+    { 
+        const auto price = ladder.BestPrice(); 
+        if (protection.HasValue() && Ladder::IsBetter(protection, price))
+            break; 
+        if (marketSweepLevels_ && levelsSwept == marketSweepLevels_)
+            break; 
+
+        auto& level = ladder.BestLevel(); 
+        while (!order.IsFilled() && !level.Empty())
+        { 
+            const auto restingLocation = level.orders_.Front(); 
+            auto& resting = pool_[restingLocation]; 
+
+            const Quantity quantity = std::min(order.GetRemainingQuantity(), 
+                resting.GetRemainingQuantity()); 
+
+            order.Fill(quantity); 
+            resting.Fill(quantity); 
+
+            //Both sides of the trade execute at the resting order's price
+            const TradeInfo aggressor{ order.GetOrderId(), price, quantity }; 
+            const TradeInfo passive{ resting.GetOrderId(), price, quantity }; 
+            sink(order.GetSide() == Side::Buy ? Trade{ aggressor, passive } 
+                                              : Trade{ passive, aggressor }); 
+
+            OnOrderMatched(level, resting, quantity); 
+
+            if (resting.IsFilled())
+            { 
+                level.orders_.PopFront(pool_); 
+                orders_.Erase(resting.GetOrderId()); 
+                ReleaseOrder(restingLocation); 
+            }
+        }
+
+        if (!level.Empty())
+            break; 
+
+        ladder.EraseLevel(price); 
+        ++levelsSwept; 
     }
-    return trades; 
+}
+
+void Orderbook::SweepMarketOrder(Order& order, TradeSink sink)
+{ 
+    if (order.GetSide() == Side::Buy)
+        SweepLevels(order, asks_, sink); 
+    else 
+        SweepLevels(order, bids_, sink); 
 }
 
 Orderbook::Orderbook()
-    : orderPruningThread_{ [this]{ PruneGoodForDayOrders(); } }
+    : Orderbook(OrderbookConfig{ })
     {}
 
+Orderbook::Orderbook(const OrderbookConfig& config)
+    : bids_{ config.bandTicks_ }, asks_{ config.bandTicks_ }, 
+      orders_{ config.sequentialOrderIds_ ? OrderIdIndex<OrderEntry>::Mode::Dense 
+                                          : OrderIdIndex<OrderEntry>::Mode::Hashed, 
+               config.expectedOrders_ }, 
+      pool_{ config.expectedOrders_ }, 
+      marketSweepLevels_{ config.marketSweepLevels_ }, 
+      expiryChunkSize_{ std::max<std::size_t>(config.expiryChunkSize_, 1) }, 
+      singleWriter_{ config.singleWriter_ }, 
+      mirror_{ config.mirror_ }, 
+      clock_{ config.clock_ ? *config.clock_ : WallClock::Instance() }, 
+      journal_{ config.journal_ }
+{ 
+    bids_.Anchor(config.referencePrice_); 
+    asks_.Anchor(config.referencePrice_); 
+}
+
 Orderbook::~Orderbook() 
 { 
-    shutdown_.store(true, std::memory_order_release); 
-    shutdownConditionVariable_.notify_one(); 
-    orderPruningThread_.join(); 
+    //Waits out an expiry already running, which needs the lock
+    Clock::TaskId expiryTask; 
+    { 
+        auto ordersLock = LockOrders(); 
+        expiryTask = expiryTask_; 
+    }
+
+    if (expiryTask != Clock::NoTask)
+        clock_.Cancel(expiryTask); 
 }
 
 Trades Orderbook::AddOrder(OrderPointer order)
 { 
-    std::scoped_lock ordersLock{ ordersMutex_ }; 
+    return AddOrder(*order); 
+}
 
-    if (orders_.contains(order->GetOrderId()))
-        return { }; 
-    
-    /*Market orders redefined as GoodTillCancel orders at worst bid or ask  
-      to allow same behavior without extra branch to handle Market type */
-    if (order->GetOrderType() == OrderType::Market) 
+Trades Orderbook::AddOrder(Order order)
+{ 
+    Trades trades; 
+    AddOrder(order, trades); 
+    return trades; 
+}
+
+void Orderbook::AddOrder(Order order, TradeSink sink)
+{ 
+    //Taken before matching fills the order
+    const auto command = Command::Add(0, order); 
+    auto ordersLock = LockOrders(); 
+
+    if (AddOrderInternal(order, sink))
     { 
-        if (order->GetSide() == Side::Buy && !asks_.empty())
-        { 
-            const auto& [worstAsk, _] = *asks_.rbegin(); 
-            order->ToGoodTillCancel(worstAsk); 
-        }
-        else if (order->GetSide() == Side::Sell && !bids_.empty()) 
-        { 
-            const auto& [worstBid, _] = *bids_.rbegin(); 
-            order->ToGoodTillCancel(worstBid); 
-        } 
-        else
-            return { }; 
+        Record(command); 
+        PublishSnapshot(); 
     }
-    
-    if (order->GetOrderType() == OrderType::FillAndKill
-        && !CanMatch(order->GetSide(), order->GetPrice()))
-            return { }; 
-    
-    if (order->GetOrderType() == OrderType::FillOrKill
-        && !CanFullyFill(order->GetSide(), order->GetPrice(), order->GetInitialQuantity()))
-            return { }; 
-    
-    OrderPointers::iterator iterator; 
+}
 
-    if (order->GetSide() == Side::Buy) 
-    { 
-        auto& orders = bids_[order->GetPrice()]; 
-        orders.push_back(order); 
-        iterator = std::next(orders.begin(), orders.size()-1); 
-    } 
-    else 
+bool Orderbook::AddOrderInternal(Order& order, TradeSink sink)
+{ 
+    //The index reserves its empty key, an order under it could rest but never be found
+    if (order.GetOrderId() == OrderIdIndex<OrderEntry>::EmptyKey || orders_.Contains(order.GetOrderId()))
+        return false; 
+    
+    //Market orders take liquidity in one pass and never touch the book's indexes
+    if (order.GetOrderType() == OrderType::Market) 
     { 
-        auto& orders = asks_[order->GetPrice()]; 
-        orders.push_back(order); 
-        iterator = std::next(orders.begin(), orders.size()-1); 
+        if (mirror_)
+            return false; 
+
+        const auto remaining = order.GetRemainingQuantity(); 
+        SweepMarketOrder(order, sink); 
+        return order.GetRemainingQuantity() != remaining; 
     }
     
-    orders_[order->GetOrderId()] = OrderEntry { order, iterator }; ; 
-
-    OnOrderAdded(order); 
+    if (order.GetOrderType() == OrderType::FillAndKill
+        && !CanMatch(order.GetSide(), order.GetPrice()))
+            return false; 
+    
+    if (order.GetOrderType() == OrderType::FillOrKill
+        && !CanFullyFill(order.GetSide(), order.GetPrice(), order.GetInitialQuantity()))
+            return false; 
+    
+    RestOrder(order); 
 
-    return MatchOrders(); 
+    //The book was uncrossed before, so only a crossing order can trade
+    if (CanMatch(order.GetSide(), order.GetPrice()))
+        MatchOrders(sink); 
+    return true; 
 }
 
 
 //Removes order with orderId from orderbook
 void Orderbook::CancelOrder(OrderId orderId) 
 { 
-    std::scoped_lock ordersLock{ ordersMutex_ }; 
+    auto ordersLock = LockOrders(); 
 
-    CancelOrderInternal(orderId); 
+    if (CancelOrderInternal(orderId))
+    { 
+        Record(Command::Cancel(0, orderId)); 
+        PublishSnapshot(); 
+    }
 }
 
 
@@ -340,26 +475,260 @@ version and add the modified order. Returns Trades made as a result
 of the addition*/
 Trades Orderbook::ModifyOrder(OrderModify order) 
 { 
-    OrderType orderType; 
-    {
-        std::scoped_lock ordersLock{ ordersMutex_ }; 
+    Trades trades; 
+    ModifyOrder(order, trades); 
+    return trades; 
+}
+
+void Orderbook::ModifyOrder(OrderModify order, TradeSink sink) 
+{ 
+    auto ordersLock = LockOrders(); 
+
+    if (ModifyOrderInternal(order, sink))
+    { 
+        Record(Command::Modify(0, order)); 
+        PublishSnapshot(); 
+    }
+}
+
+bool Orderbook::ModifyOrderInternal(const OrderModify& order, TradeSink sink) 
+{ 
+    const auto* orderEntry = orders_.Find(order.GetOrderId()); 
+    if (!orderEntry)
+        return false; 
+
+    if (!order.GetQuantity())
+        return CancelOrderInternal(order.GetOrderId()); 
+
+    const auto location = orderEntry->location_; 
+    auto& existingOrder = pool_[location]; 
+
+    //Size reductions in place keep the order's time priority and cannot cross
+    if (order.GetSide() == existingOrder.GetSide() 
+        && order.GetPrice() == existingOrder.GetPrice() 
+        && order.GetQuantity() <= existingOrder.GetRemainingQuantity())
+    { 
+        const auto reduction = existingOrder.GetRemainingQuantity() - order.GetQuantity(); 
+        auto& level = existingOrder.GetSide() == Side::Buy 
+            ? *bids_.FindLevel(existingOrder.GetPrice()) 
+            : *asks_.FindLevel(existingOrder.GetPrice()); 
+
+        existingOrder.ReduceQuantity(reduction); 
+        UpdateLevelData(level, existingOrder.GetSide(), existingOrder.GetPrice(), 
+            reduction, PriceLevel::Action::Match); 
+        return true; 
+    }
+
+    //Anything else relinks the same pooled order at the back of its new level
+    UnlinkOrder(location, existingOrder); 
+    existingOrder.Amend(order.GetSide(), order.GetPrice(), order.GetQuantity()); 
+    LinkOrder(location, existingOrder); 
+
+    if (CanMatch(existingOrder.GetSide(), existingOrder.GetPrice()))
+        MatchOrders(sink); 
+    return true; 
+}
+
+
+bool Orderbook::Apply(const Command& command, TradeSink sink) 
+{ 
+    auto ordersLock = LockOrders(); 
+
+    if (!ApplyInternal(command, sink))
+        return false; 
+
+    Record(command); 
+    PublishSnapshot(); 
+    return true; 
+}
+
+void Orderbook::Submit(std::span<const Command> commands, TradeSink sink) 
+{ 
+    auto ordersLock = LockOrders(); 
+
+    bool changed{ false }; 
+    for (const auto& command : commands)
+    { 
+        if (!ApplyInternal(command, sink))
+            continue; 
+
+        Record(command); 
+        changed = true; 
+    }
+
+    if (changed)
+        PublishSnapshot(); 
+}
+
+void Orderbook::Replay(std::span<const JournalRecord> records) 
+{ 
+    auto ordersLock = LockOrders(); 
 
-        if (!orders_.contains(order.GetOrderId()))
-            return { }; 
+    bool changed{ false }; 
+    for (const auto& record : records)
+    { 
+        if (record.sequence_ <= lastSequence_)
+            continue; 
 
-        const auto& [existingOrder, _] = orders_[order.GetOrderId()]; 
-        orderType = existingOrder->GetOrderType(); 
+        ApplyInternal(record.command_, TradeSink::Discard()); 
+        lastSequence_ = record.sequence_; 
+        changed = true; 
     }
 
-    CancelOrder(order.GetOrderId()); 
-    return AddOrder(order.ToOrderPointer(orderType));
+    if (changed)
+        PublishSnapshot(); 
+}
+
+SnapshotImage Orderbook::CaptureSnapshot() const 
+{ 
+    SnapshotImage image; 
+    CaptureSnapshot(image); 
+    return image; 
+}
+
+void Orderbook::CaptureSnapshot(SnapshotImage& image) const 
+{ 
+    //Sized from the published snapshot, so the copy under the lock rarely allocates
+    image.orders_.clear(); 
+    image.orders_.reserve(Size()); 
+
+    auto ordersLock = LockOrders(); 
+    image.lastSequence_ = lastSequence_; 
+    image.orders_.resize(orders_.Size()); 
+
+    //Each level's head and where its orders go, known up front from the level counts
+    snapshotCursors_.clear(); 
+    auto* next = image.orders_.data(); 
+    auto placeLevel = [this, &next](Price, const PriceLevel& level)
+    { 
+        snapshotCursors_.push_back(SnapshotCursor{ level.orders_.Front(), next }); 
+        next += level.orderCount_; 
+        return true; 
+    }; 
+    bids_.ForEachLevel(placeLevel); 
+    asks_.ForEachLevel(placeLevel); 
+
+    /*Walking one queue stalls on every link, so several are walked in 
+    turn and their cache misses overlap*/
+    constexpr std::size_t Lanes{ 16 }; 
+    std::array<SnapshotCursor, Lanes> lanes; 
+    std::size_t active{ }, nextLevel{ }; 
+    while (active < Lanes && nextLevel < snapshotCursors_.size())
+        lanes[active++] = snapshotCursors_[nextLevel++]; 
+
+    while (active)
+    { 
+        for (std::size_t lane = 0; lane < active; )
+        { 
+            auto& cursor = lanes[lane]; 
+            const auto& order = pool_[cursor.index_]; 
+            *cursor.out_++ = SnapshotOrder{ order.GetOrderId(), order.GetPrice(), 
+                order.GetInitialQuantity(), order.GetRemainingQuantity(), 
+                static_cast<std::uint8_t>(order.GetOrderType()), static_cast<std::uint8_t>(order.GetSide()) }; 
+
+            cursor.index_ = order.GetNext(); 
+            if (cursor.index_ != InvalidOrderIndex)
+                ++lane; 
+            else if (nextLevel < snapshotCursors_.size())
+                cursor = snapshotCursors_[nextLevel++]; 
+            else
+                cursor = lanes[--active]; 
+        }
+    }
+}
+
+void Orderbook::Restore(std::span<const SnapshotOrder> orders, std::uint64_t lastSequence) 
+{ 
+    auto ordersLock = LockOrders(); 
+    if (orders_.Size() || lastSequence_)
+        throw std::logic_error("Snapshots can only be restored into an empty book"); 
+
+    //Sized once up front, growing as orders arrive would rehash and copy repeatedly
+    if (!orders.empty())
+    { 
+        const auto [lowest, highest] = std::minmax_element(orders.begin(), orders.end(), 
+            [](const SnapshotOrder& left, const SnapshotOrder& right){ return left.orderId_ < right.orderId_; }); 
+        orders_.Reserve(orders.size(), lowest->orderId_, highest->orderId_); 
+        pool_.Reserve(orders.size()); 
+    }
+
+    for (const auto& stored : orders)
+    { 
+        Order order{ static_cast<OrderType>(stored.orderType_), stored.orderId_, 
+            static_cast<Side>(stored.side_), stored.price_, stored.initialQuantity_ }; 
+        order.Fill(order.GetInitialQuantity() - stored.remainingQuantity_); 
+
+        //Resting it regardless would leave an order queued that the id index cannot find
+        if (!RestOrder(order))
+            throw std::logic_error(std::format("Snapshot order id {} is repeated or reserved", stored.orderId_)); 
+    }
+
+    lastSequence_ = lastSequence; 
+    PublishSnapshot(); 
+}
+
+std::uint64_t Orderbook::LastSequence() const 
+{ 
+    auto ordersLock = LockOrders(); 
+    return lastSequence_; 
+}
+
+void Orderbook::Record(const Command& command) 
+{ 
+    ++lastSequence_; 
+    if (journal_)
+        journal_->Append(JournalRecord{ lastSequence_, command }); 
+}
+
+bool Orderbook::ApplyInternal(const Command& command, TradeSink sink) 
+{ 
+    switch (command.kind_)
+    { 
+        case Command::Kind::Add: 
+        { 
+            auto order = command.ToOrder(); 
+            return AddOrderInternal(order, sink); 
+        }
+        case Command::Kind::Cancel: 
+            return CancelOrderInternal(command.orderId_); 
+        case Command::Kind::Modify: 
+            return ModifyOrderInternal(command.ToOrderModify(), sink); 
+    }
+    return false; 
 }
 
 
 std::size_t Orderbook::Size() const 
 {   
-    std::scoped_lock ordersLock{ ordersMutex_ }; 
-    return orders_.size(); 
+    return static_cast<std::size_t>(snapshot_.Load().orderCount_); 
+}
+
+
+BookSnapshot Orderbook::GetSnapshot() const 
+{ 
+    return snapshot_.Load(); 
+}
+
+
+void Orderbook::PublishSnapshot() 
+{ 
+    BookSnapshot snapshot; 
+    snapshot.orderCount_ = orders_.Size(); 
+    snapshot.sequence_ = snapshot_.Version() + 1; 
+
+    bids_.ForEachLevel([&](Price price, const PriceLevel& level)
+    { 
+        snapshot.bids_[snapshot.bidDepth_++] = LevelInfo{ price, level.quantity_, level.orderCount_ }; 
+        return snapshot.bidDepth_ < BookSnapshot::MaxDepth; 
+    });
+
+    asks_.ForEachLevel([&](Price price, const PriceLevel& level)
+    { 
+        snapshot.asks_[snapshot.askDepth_++] = LevelInfo{ price, level.quantity_, level.orderCount_ }; 
+        return snapshot.askDepth_ < BookSnapshot::MaxDepth; 
+    });
+
+    snapshot_.Store(snapshot); 
 }
    
 
@@ -367,31 +736,24 @@ std::size_t Orderbook::Size() const
 OrderbookLevelInfos Orderbook::GetOrderInfos() const 
 { 
     LevelInfos bidInfos, askInfos; 
-    bidInfos.reserve(Size()); 
-    askInfos.reserve(Size()); 
+
+    //Held across both walks so they see one consistent book
+    auto ordersLock = LockOrders(); 
+    bidInfos.reserve(orders_.Size()); 
+    askInfos.reserve(orders_.Size()); 
     
-    //Generic function to create LevelInfo for a price level
-    auto CreateLevelInfo = [](Price price, const OrderPointers& orders)
+    //Levels carry their own aggregates, so each LevelInfo is O(1)
+    bids_.ForEachLevel([&](Price price, const PriceLevel& level)
     { 
-        return LevelInfo
-        { 
-        price,
-        std::accumulate(orders.begin(), orders.end(), Quantity(0), 
-                        [](Quantity runningSum, const auto& order)
-                        {
-                            return runningSum + order->GetRemainingQuantity(); 
-                        }), 
-        (Quantity) orders.size()
-        };
-    }; 
-
-    for (const auto& [price, orders] : bids_)
-        bidInfos.push_back(CreateLevelInfo(price, orders));
+        bidInfos.push_back(LevelInfo{ price, level.quantity_, level.orderCount_ });
+        return true; 
+    });
     
-    for (const auto& [price, orders] : asks_)
-        askInfos.push_back(CreateLevelInfo(price, orders));
-
+    asks_.ForEachLevel([&](Price price, const PriceLevel& level)
+    { 
+        askInfos.push_back(LevelInfo{ price, level.quantity_, level.orderCount_ });
+        return true; 
+    });
 
     return OrderbookLevelInfos { bidInfos, askInfos }; 
 }
-
@@ -0,0 +1,70 @@
+#include "OrderbookEngine.h"
+
+#include <thread>
+
+#include "MatcherLoop.h"
+
+OrderbookEngine::OrderbookEngine(std::size_t clientCount, const OrderbookConfig& config)
+    : book_{ config.SingleWriter() }
+{ 
+    clients_.reserve(clientCount); 
+    for (std::size_t client = 0; client < clientCount; ++client)
+        clients_.push_back(std::make_unique<Client>()); 
+
+    thread_ = std::thread{ [this]{ Run(); } }; 
+}
+
+OrderbookEngine::~OrderbookEngine() 
+{ 
+    //Commands still queued are dropped
+    stop_.store(true, std::memory_order_relaxed); 
+    thread_.join(); 
+}
+
+bool OrderbookEngine::TrySubmit(std::size_t client, const Command& command, std::uint64_t tag) 
+{ 
+    return clients_[client]->requests_.TryPush(Request{ command, tag }); 
+}
+
+bool OrderbookEngine::TryPoll(std::size_t client, Response& response) 
+{ 
+    return clients_[client]->responses_.TryPop(response); 
+}
+
+void OrderbookEngine::Run() 
+{ 
+    MatcherLoop loop{ book_ }; 
+
+    while (!stop_.load(std::memory_order_relaxed))
+    { 
+        bool worked{ false }; 
+
+        //One request per client per pass, so no client can starve the others
+        for (auto& client : clients_)
+        { 
+            Request request; 
+            if (!client->requests_.TryPop(request))
+                continue; 
+
+            const auto tag = request.tag_; 
+            book_.Apply(request.command_, [this, &client = *client, tag](const Trade& trade)
+            { 
+                Respond(client, Response{ Response::Kind::Fill, tag, trade }); 
+            }); 
+            Respond(*client, Response{ Response::Kind::Done, tag }); 
+            worked = true; 
+        }
+
+        loop.EndPass(worked); 
+    }
+}
+
+void OrderbookEngine::Respond(Client& client, const Response& response) 
+{ 
+    while (!client.responses_.TryPush(response))
+    { 
+        if (stop_.load(std::memory_order_relaxed))
+            return; 
+        std::this_thread::yield(); 
+    }
+}
@@ -0,0 +1,131 @@
+#include "OrderbookManager.h"
+
+#include <algorithm>
+
+OrderbookManager::OrderbookManager(std::size_t shardCount, 
+    const OrderbookConfig& bookConfig, TradeListener tradeListener)
+    : bookConfig_{ bookConfig }, tradeListener_{ std::move(tradeListener) }
+{ 
+    if (!shardCount)
+        shardCount = std::max(1u, std::thread::hardware_concurrency()); 
+
+    shards_.reserve(shardCount); 
+    for (std::size_t index = 0; index < shardCount; ++index)
+        shards_.push_back(std::make_unique<Shard>()); 
+
+    //Threads start only once the shard vector is complete
+    for (auto& shard : shards_)
+        shard->thread_ = std::thread{ [this, &shard = *shard]{ RunShard(shard); } }; 
+}
+
+OrderbookManager::~OrderbookManager() 
+{ 
+    for (auto& shard : shards_)
+    { 
+        { 
+            std::scoped_lock shardLock{ shard->mutex_ }; 
+            shard->shutdown_ = true; 
+        }
+        shard->pendingConditionVariable_.notify_one(); 
+    }
+
+    for (auto& shard : shards_)
+        shard->thread_.join(); 
+}
+
+void OrderbookManager::Submit(const Command& command) 
+{ 
+    auto& shard = ShardFor(command.symbolId_); 
+    bool wasEmpty; 
+
+    { 
+        std::scoped_lock shardLock{ shard.mutex_ }; 
+        wasEmpty = shard.pending_.empty(); 
+        shard.pending_.push_back(command); 
+        ++shard.submitted_; 
+    }
+
+    //The thread only sleeps once it has drained the queue
+    if (wasEmpty)
+        shard.pendingConditionVariable_.notify_one(); 
+}
+
+void OrderbookManager::Flush() 
+{ 
+    for (auto& shard : shards_)
+    { 
+        std::unique_lock shardLock{ shard->mutex_ }; 
+        const auto target = shard->submitted_; 
+        shard->idleConditionVariable_.wait(shardLock, [&shard, target]{ return shard->applied_ >= target; }); 
+    }
+}
+
+std::size_t OrderbookManager::Size(SymbolId symbolId) const 
+{ 
+    const auto& shard = ShardFor(symbolId); 
+    std::scoped_lock shardLock{ shard.mutex_ }; 
+
+    const auto book = shard.books_.find(symbolId); 
+    return book == shard.books_.end() ? 0 : book->second->Size(); 
+}
+
+OrderbookLevelInfos OrderbookManager::GetOrderInfos(SymbolId symbolId) const 
+{ 
+    const auto& shard = ShardFor(symbolId); 
+    std::scoped_lock shardLock{ shard.mutex_ }; 
+
+    const auto book = shard.books_.find(symbolId); 
+    return book == shard.books_.end() ? OrderbookLevelInfos{ { }, { } } : book->second->GetOrderInfos(); 
+}
+
+void OrderbookManager::RunShard(Shard& shard) 
+{ 
+    std::vector<Command> batch; 
+
+    while (true)
+    { 
+        { 
+            std::unique_lock shardLock{ shard.mutex_ }; 
+            shard.applied_ += batch.size(); 
+            if (shard.applied_ == shard.submitted_)
+                shard.idleConditionVariable_.notify_all(); 
+
+            shard.pendingConditionVariable_.wait(shardLock, [&shard]
+                { return shard.shutdown_ || !shard.pending_.empty(); }); 
+
+            if (shard.pending_.empty())
+                return; 
+
+            //Swapping keeps both vectors' capacity, so steady flow allocates nothing
+            batch.clear(); 
+            batch.swap(shard.pending_); 
+
+            for (const auto& command : batch)
+                if (!shard.books_.contains(command.symbolId_))
+                    shard.books_.emplace(command.symbolId_, std::make_unique<Orderbook>(bookConfig_)); 
+        }
+
+        //Consecutive commands for one symbol go to its book as one batch
+        for (auto first = batch.begin(); first != batch.end(); )
+        { 
+            const auto last = std::find_if(first, batch.end(), [first](const Command& command)
+                { return command.symbolId_ != first->symbolId_; }); 
+            Apply(shard, std::span<const Command>{ first, last }); 
+            first = last; 
+        }
+    }
+}
+
+void OrderbookManager::Apply(Shard& shard, std::span<const Command> commands) 
+{ 
+    const auto symbolId = commands.front().symbolId_; 
+    auto& book = *shard.books_.find(symbolId)->second; 
+
+    auto OnTrade = [this, symbolId](const Trade& trade)
+    { 
+        if (tradeListener_)
+            tradeListener_(symbolId, trade); 
+    }; 
+
+    book.Submit(commands, OnTrade); 
+}
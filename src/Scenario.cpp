@@ -0,0 +1,84 @@
+#include "Scenario.h"
+
+#include "Orderbook.h"
+#include "ScenarioReader.h"
+
+namespace
+{
+    Scenario Collect(ScenarioReader& reader)
+    {
+        Scenario scenario;
+        for (const auto& command : reader)
+            scenario.commands_.push_back(command);
+
+        scenario.expected_ = reader.Expected();
+        return scenario;
+    }
+
+    ScenarioResult ResultOf(const Orderbook& orderbook)
+    {
+        const auto orderbookLevelInfos = orderbook.GetOrderInfos();
+        return ScenarioResult{ orderbook.Size(),
+            orderbookLevelInfos.GetBidCount(), orderbookLevelInfos.GetAskCount() };
+    }
+}
+
+Scenario ScenarioParser::Parse(const std::filesystem::path& path) const
+{
+    ScenarioReader reader{ path };
+    return Collect(reader);
+}
+
+Scenario ScenarioParser::ParseText(std::string_view text) const
+{
+    ScenarioReader reader{ text };
+    return Collect(reader);
+}
+
+ScenarioOutcome ReplayScenario(std::span<const Command> commands, const OrderbookConfig& config, ReplayMode mode)
+{
+    ScenarioOutcome outcome;
+    outcome.commands_ = commands.size();
+    auto countTrade = [&outcome](const Trade&) { ++outcome.trades_; };
+
+    Orderbook orderbook{ config };
+    if (mode == ReplayMode::Batched)
+        orderbook.Submit(commands, countTrade);
+    else
+    {
+        for (const auto& command : commands)
+        {
+            switch (command.kind_)
+            {
+            case Command::Kind::Add:
+                orderbook.AddOrder(command.ToOrder(), countTrade);
+                break;
+            case Command::Kind::Modify:
+                orderbook.ModifyOrder(command.ToOrderModify(), countTrade);
+                break;
+            case Command::Kind::Cancel:
+                orderbook.CancelOrder(command.orderId_);
+                break;
+            }
+        }
+    }
+
+    outcome.actual_ = ResultOf(orderbook);
+    return outcome;
+}
+
+ScenarioOutcome ReplayScenario(ScenarioReader& reader, const OrderbookConfig& config)
+{
+    ScenarioOutcome outcome;
+    auto countTrade = [&outcome](const Trade&) { ++outcome.trades_; };
+
+    Orderbook orderbook{ config };
+    for (const auto& command : reader)
+    {
+        orderbook.Apply(command, countTrade);
+        ++outcome.commands_;
+    }
+
+    outcome.actual_ = ResultOf(orderbook);
+    return outcome;
+}
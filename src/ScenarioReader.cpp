@@ -0,0 +1,172 @@
+#include "ScenarioReader.h"
+
+#include <format>
+#include <limits>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    /*Splits the next space separated field off the front of line. Fields are
+      a few bytes long, too short for memchr's call to pay for itself*/
+    std::string_view NextField(std::string_view& line)
+    {
+        std::size_t length{ 0 };
+        while (length != line.size() && line[length] != ' ')
+            ++length;
+
+        const std::string_view field{ line.data(), length };
+        line.remove_prefix(length == line.size() ? length : length + 1);
+        return field;
+    }
+
+    [[noreturn]] void Fail(std::size_t lineNumber, std::string_view what, std::string_view text)
+    {
+        throw std::logic_error(std::format("Line {}: {}: {}", lineNumber, what, text));
+    }
+
+    std::uint64_t ParseNumber(std::string_view field, std::size_t lineNumber, std::string_view what)
+    {
+        if (!field.empty() && field.front() == '-')
+            Fail(lineNumber, "Only non-negative values allowed", field);
+
+        std::uint64_t value{ };
+        const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (field.empty() || error != std::errc{ } || end != field.data() + field.size())
+            Fail(lineNumber, what, field);
+        return value;
+    }
+
+    Quantity ParseQuantity(std::string_view field, std::size_t lineNumber)
+    {
+        const auto value = ParseNumber(field, lineNumber, "Invalid quantity");
+        if (value > std::numeric_limits<Quantity>::max())
+            Fail(lineNumber, "Invalid quantity", field);
+        return static_cast<Quantity>(value);
+    }
+
+    Side ParseSide(std::string_view field, std::size_t lineNumber)
+    {
+        if (field == "B")
+            return Side::Buy;
+        if (field == "S")
+            return Side::Sell;
+        Fail(lineNumber, "Invalid side", field);
+    }
+
+    //Told apart by length and first letter before a single full comparison
+    OrderType ParseOrderType(std::string_view field, std::size_t lineNumber)
+    {
+        switch (field.size())
+        {
+            case 6:
+                if (field == "Market")
+                    return OrderType::Market;
+                break;
+            case 10:
+                if (field[4] == 'F' && field == "GoodForDay")
+                    return OrderType::GoodForDay;
+                if (field == "FillOrKill")
+                    return OrderType::FillOrKill;
+                break;
+            case 11:
+                if (field == "FillAndKill")
+                    return OrderType::FillAndKill;
+                break;
+            case 14:
+                if (field == "GoodTillCancel")
+                    return OrderType::GoodTillCancel;
+                break;
+        }
+        Fail(lineNumber, "Invalid order type", field);
+    }
+
+    Price ParsePrice(std::string_view field, std::size_t lineNumber)
+    {
+        const auto price = Price::FromString(field);
+        if (!price)
+            Fail(lineNumber, "Invalid price", field);
+        return *price;
+    }
+}
+
+ScenarioReader::ScenarioReader(const std::filesystem::path& path)
+    : file_{ std::make_unique<MappedFile>(path) }
+{
+    const auto bytes = file_->Bytes();
+    text_ = { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+}
+
+ScenarioReader::ScenarioReader(std::string_view text)
+    : text_{ text }
+{ }
+
+ScenarioReader::Iterator::Iterator(ScenarioReader& reader)
+    : reader_{ &reader }, cursor_{ reader.text_.data() }, end_{ reader.text_.data() + reader.text_.size() }
+{
+    reader.expected_.reset();
+    Advance();
+}
+
+void ScenarioReader::Iterator::Advance()
+{
+    while (cursor_ != end_)
+    {
+        const auto* newline = static_cast<const char*>(std::memchr(cursor_, '\n', static_cast<std::size_t>(end_ - cursor_)));
+        const auto* lineEnd = newline ? newline : end_;
+        std::string_view line{ cursor_, static_cast<std::size_t>(lineEnd - cursor_) };
+        cursor_ = newline ? newline + 1 : end_;
+        ++lineNumber_;
+
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            break;
+
+        const auto kind = NextField(line);
+        if (kind == "A")
+        {
+            const auto side = ParseSide(NextField(line), lineNumber_);
+            const auto orderType = ParseOrderType(NextField(line), lineNumber_);
+            const auto price = ParsePrice(NextField(line), lineNumber_);
+            const auto quantity = ParseQuantity(NextField(line), lineNumber_);
+            const auto orderId = ParseNumber(NextField(line), lineNumber_, "Invalid order id");
+
+            //A Market line's price is its protection limit, zero for none
+            const auto limit = orderType == OrderType::Market && price == Price{ 0 } ? Price::None() : price;
+            command_ = Command{ Command::Kind::Add, orderType, side, 0, orderId, limit, quantity };
+            return;
+        }
+        if (kind == "M")
+        {
+            const auto orderId = ParseNumber(NextField(line), lineNumber_, "Invalid order id");
+            const auto side = ParseSide(NextField(line), lineNumber_);
+            const auto price = ParsePrice(NextField(line), lineNumber_);
+            const auto quantity = ParseQuantity(NextField(line), lineNumber_);
+            command_ = Command{ Command::Kind::Modify, OrderType::GoodTillCancel, side, 0, orderId, price, quantity };
+            return;
+        }
+        if (kind == "C")
+        {
+            command_ = Command::Cancel(0, ParseNumber(NextField(line), lineNumber_, "Invalid order id"));
+            return;
+        }
+        if (kind == "R")
+        {
+            if (std::string_view{ cursor_, static_cast<std::size_t>(end_ - cursor_) }.find_first_not_of("\r\n")
+                != std::string_view::npos)
+                Fail(lineNumber_, "Result line must be at end of file", kind);
+
+            const auto allCount = ParseNumber(NextField(line), lineNumber_, "Invalid result");
+            const auto bidCount = ParseNumber(NextField(line), lineNumber_, "Invalid result");
+            const auto askCount = ParseNumber(NextField(line), lineNumber_, "Invalid result");
+            reader_->expected_ = ScenarioResult{ allCount, bidCount, askCount };
+            break;
+        }
+
+        Fail(lineNumber_, "Invalid action", kind);
+    }
+
+    reader_ = nullptr;
+}
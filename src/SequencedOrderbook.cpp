@@ -0,0 +1,91 @@
+#include "SequencedOrderbook.h"
+
+#include "MatcherLoop.h"
+
+SequencedOrderbook::SequencedOrderbook(std::size_t producerCount,
+    const OrderbookConfig& config, TradeListener tradeListener)
+    : sequencer_{ std::make_unique<MpscSequencer<SequencedCommand, RingCapacity>>() },
+      tradeListener_{ std::move(tradeListener) }, book_{ config.SingleWriter() }
+{
+    producers_.reserve(producerCount);
+    for (std::size_t producer = 0; producer < producerCount; ++producer)
+        producers_.push_back(std::make_unique<Producer>());
+
+    thread_ = std::thread{ [this]{ Run(); } };
+}
+
+SequencedOrderbook::~SequencedOrderbook()
+{
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+std::uint64_t SequencedOrderbook::Submit(std::size_t producer, const Command& command)
+{
+    auto& counters = producers_[producer]->producerSide_;
+    bool stalled;
+
+    //The sequence number is only known once claimed, the matcher fills it in
+    const auto sequence = sequencer_->Publish(SequencedCommand{ 0,
+        static_cast<std::uint32_t>(producer), command }, stalled);
+
+    counters.submitted_.fetch_add(1, std::memory_order_relaxed);
+    if (stalled)
+        counters.stalls_.fetch_add(1, std::memory_order_relaxed);
+    return sequence;
+}
+
+void SequencedOrderbook::Flush() const
+{
+    const auto target = sequencer_->LastClaimed();
+    while (LastApplied() < target)
+        std::this_thread::yield();
+}
+
+SequencedOrderbook::ProducerStats SequencedOrderbook::GetProducerStats(std::size_t producer) const
+{
+    const auto& counters = *producers_[producer];
+    return ProducerStats{
+        counters.producerSide_.submitted_.load(std::memory_order_relaxed),
+        counters.producerSide_.stalls_.load(std::memory_order_relaxed),
+        counters.matcherSide_.applied_.load(std::memory_order_relaxed),
+        counters.matcherSide_.rejected_.load(std::memory_order_relaxed),
+        counters.matcherSide_.trades_.load(std::memory_order_relaxed) };
+}
+
+void SequencedOrderbook::Run()
+{
+    MatcherLoop loop{ book_ };
+
+    while (true)
+    {
+        SequencedCommand command;
+        std::uint64_t sequence;
+
+        if (sequencer_->TryConsume(command, sequence))
+        {
+            command.sequence_ = sequence;
+            auto& counters = producers_[command.producer_]->matcherSide_;
+            std::uint64_t trades{ };
+
+            const bool applied = book_.Apply(command.command_, [this, &command, &trades](const Trade& trade)
+            {
+                ++trades;
+                if (tradeListener_)
+                    tradeListener_(command, trade);
+            });
+
+            (applied ? counters.applied_ : counters.rejected_).fetch_add(1, std::memory_order_relaxed);
+            counters.trades_.fetch_add(trades, std::memory_order_relaxed);
+            lastApplied_.store(sequence, std::memory_order_release);
+            loop.EndPass(true);
+            continue;
+        }
+
+        //Producers are done by destruction, so everything claimed has been written
+        if (stop_.load(std::memory_order_acquire) && LastApplied() == sequencer_->LastClaimed())
+            return;
+
+        loop.EndPass(false);
+    }
+}
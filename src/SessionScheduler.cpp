@@ -0,0 +1,115 @@
+#include "SessionScheduler.h"
+
+#include <algorithm>
+
+SessionScheduler::SessionScheduler(std::size_t threadCount)
+{ 
+    threads_.reserve(std::max<std::size_t>(threadCount, 1)); 
+    for (std::size_t thread = 0; thread < std::max<std::size_t>(threadCount, 1); ++thread)
+        threads_.emplace_back([this]{ Run(); }); 
+}
+
+SessionScheduler::~SessionScheduler() 
+{ 
+    { 
+        std::scoped_lock schedulerLock{ mutex_ }; 
+        shutdown_ = true; 
+    }
+    tasksConditionVariable_.notify_all(); 
+
+    for (auto& thread : threads_)
+        thread.join(); 
+}
+
+SessionScheduler& SessionScheduler::Instance() 
+{ 
+    static SessionScheduler scheduler; 
+    return scheduler; 
+}
+
+SessionScheduler::TaskId SessionScheduler::ScheduleAt(TimePoint when, Task task) 
+{ 
+    bool earliest; 
+    TaskId taskId; 
+
+    { 
+        std::scoped_lock schedulerLock{ mutex_ }; 
+        taskId = nextTaskId_++; 
+        earliest = tasks_.empty() || when < tasks_.begin()->first.first; 
+
+        tasks_.emplace(std::make_pair(when, taskId), std::move(task)); 
+        dueTimes_.emplace(taskId, when); 
+    }
+
+    //Sleeping threads only need waking when the next due time moves earlier
+    if (earliest)
+        tasksConditionVariable_.notify_one(); 
+
+    return taskId; 
+}
+
+bool SessionScheduler::Cancel(TaskId taskId) 
+{ 
+    std::unique_lock schedulerLock{ mutex_ }; 
+
+    if (const auto dueTime = dueTimes_.find(taskId); dueTime != dueTimes_.end())
+    { 
+        tasks_.erase(std::make_pair(dueTime->second, taskId)); 
+        dueTimes_.erase(dueTime); 
+        return true; 
+    }
+
+    //A task cancelling itself must not wait on its own completion
+    if (threads_.end() != std::find_if(threads_.begin(), threads_.end(), 
+        [](const std::thread& thread){ return thread.get_id() == std::this_thread::get_id(); }))
+        return false; 
+
+    finishedConditionVariable_.wait(schedulerLock, [this, taskId]
+        { return std::find(running_.begin(), running_.end(), taskId) == running_.end(); }); 
+    return false; 
+}
+
+std::size_t SessionScheduler::Pending() const 
+{ 
+    std::scoped_lock schedulerLock{ mutex_ }; 
+    return tasks_.size(); 
+}
+
+void SessionScheduler::Run() 
+{ 
+    std::unique_lock schedulerLock{ mutex_ }; 
+
+    while (true)
+    { 
+        if (shutdown_)
+            return; 
+
+        if (tasks_.empty())
+        { 
+            tasksConditionVariable_.wait(schedulerLock); 
+            continue; 
+        }
+
+        const auto [dueTime, taskId] = tasks_.begin()->first; 
+        if (std::chrono::system_clock::now() < dueTime)
+        { 
+            tasksConditionVariable_.wait_until(schedulerLock, dueTime); 
+            continue; 
+        }
+
+        auto task = std::move(tasks_.begin()->second); 
+        tasks_.erase(tasks_.begin()); 
+        dueTimes_.erase(taskId); 
+        running_.push_back(taskId); 
+
+        //Another thread may now take the next due task
+        tasksConditionVariable_.notify_one(); 
+
+        schedulerLock.unlock(); 
+        task(); 
+        schedulerLock.lock(); 
+
+        running_.erase(std::find(running_.begin(), running_.end(), taskId)); 
+        finishedConditionVariable_.notify_all(); 
+    }
+}
@@ -0,0 +1,106 @@
+#include "SnapshotFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    //Size of three orders, so orders stay aligned when the file is mapped
+    struct SnapshotHeader
+    {
+        char magic_[8]{ 'O', 'B', 'S', 'N', 'A', 'P', 'S', 'H' };
+        std::uint32_t version_{ SnapshotReader::Version };
+        std::uint32_t orderSize_{ sizeof(SnapshotOrder) };
+        std::uint64_t lastSequence_{ };
+        std::uint64_t orderCount_{ };
+        std::uint8_t reserved_[40]{ };
+    };
+
+    static_assert(sizeof(SnapshotHeader) % sizeof(SnapshotOrder) == 0);
+
+    [[noreturn]] void ThrowError(int error, const std::string& what)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void WriteAll(int fd, const void* data, std::size_t size, const std::filesystem::path& path)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size)
+        {
+            const auto written = ::write(fd, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                const int error = errno;
+                ::close(fd);
+                ThrowError(error, "Cannot write snapshot " + path.string());
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+}
+
+void WriteSnapshotFile(const std::filesystem::path& path, const SnapshotImage& image)
+{
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    const int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        ThrowError(errno, "Cannot create snapshot " + temporaryPath.string());
+
+    SnapshotHeader header;
+    header.lastSequence_ = image.lastSequence_;
+    header.orderCount_ = image.orders_.size();
+    WriteAll(fd, &header, sizeof(header), temporaryPath);
+    WriteAll(fd, image.orders_.data(), image.orders_.size() * sizeof(SnapshotOrder), temporaryPath);
+
+    if (::fsync(fd) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        ThrowError(error, "Cannot sync snapshot " + temporaryPath.string());
+    }
+    ::close(fd);
+
+    if (::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        ThrowError(errno, "Cannot rename snapshot to " + path.string());
+
+    //The rename is only durable once the directory is
+    const auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path{ "." };
+    if (const int directoryFd = ::open(directory.c_str(), O_RDONLY); directoryFd >= 0)
+    {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+}
+
+SnapshotReader::SnapshotReader(const std::filesystem::path& path)
+    : file_{ path }
+{
+    const auto bytes = file_.Bytes();
+    if (bytes.size() < sizeof(SnapshotHeader))
+        throw std::logic_error("Snapshot too short: " + path.string());
+
+    SnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic_, SnapshotHeader{ }.magic_, sizeof(header.magic_)) != 0
+        || header.version_ != Version || header.orderSize_ != sizeof(SnapshotOrder))
+        throw std::logic_error("Not a version " + std::to_string(Version) + " snapshot: " + path.string());
+
+    //Divides rather than multiplies, so a huge count cannot wrap into a match
+    const auto payload = bytes.size() - sizeof(header);
+    if (payload % sizeof(SnapshotOrder) || header.orderCount_ != payload / sizeof(SnapshotOrder))
+        throw std::logic_error("Snapshot size does not match its order count: " + path.string());
+
+    lastSequence_ = header.lastSequence_;
+    orders_ = { reinterpret_cast<const SnapshotOrder*>(bytes.data() + sizeof(header)), header.orderCount_ };
+}
@@ -0,0 +1,82 @@
+#include "SnapshotWriter.h"
+
+#include <utility>
+
+SnapshotWriter::SnapshotWriter()
+{
+    thread_ = std::thread{ [this]{ Run(); } };
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    {
+        std::scoped_lock writerLock{ mutex_ };
+        shutdown_ = true;
+    }
+    pendingConditionVariable_.notify_one();
+    thread_.join();
+}
+
+void SnapshotWriter::Write(std::filesystem::path path, SnapshotImage image)
+{
+    {
+        std::scoped_lock writerLock{ mutex_ };
+        pending_.push_back(Job{ std::move(path), std::move(image) });
+    }
+    pendingConditionVariable_.notify_one();
+}
+
+std::uint64_t SnapshotWriter::Wait()
+{
+    std::unique_lock writerLock{ mutex_ };
+    idleConditionVariable_.wait(writerLock, [this]{ return pending_.empty() && !writing_; });
+
+    if (error_)
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    return lastWritten_;
+}
+
+SnapshotImage SnapshotWriter::SpareImage()
+{
+    std::scoped_lock writerLock{ mutex_ };
+    return std::exchange(spare_, SnapshotImage{ });
+}
+
+void SnapshotWriter::Run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock writerLock{ mutex_ };
+            pendingConditionVariable_.wait(writerLock, [this]{ return shutdown_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+
+            job = std::move(pending_.front());
+            pending_.pop_front();
+            writing_ = true;
+        }
+
+        std::exception_ptr error;
+        try
+        {
+            WriteSnapshotFile(job.path_, job.image_);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        {
+            std::scoped_lock writerLock{ mutex_ };
+            writing_ = false;
+            if (error && !error_)
+                error_ = error;
+            else if (!error)
+                lastWritten_ = job.image_.lastSequence_;
+            spare_ = std::move(job.image_);
+        }
+        idleConditionVariable_.notify_all();
+    }
+}
@@ -0,0 +1,116 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    //Lets Submit from a task push onto the deque of the thread running it
+    thread_local const WorkStealingPool* currentPool{ nullptr };
+    thread_local std::size_t currentWorker{ 0 };
+}
+
+WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+{
+    if (!threadCount)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    workers_.reserve(threadCount);
+    for (std::size_t index = 0; index < threadCount; ++index)
+        workers_.push_back(std::make_unique<Worker>());
+
+    threads_.reserve(threadCount);
+    for (std::size_t index = 0; index < threadCount; ++index)
+        threads_.emplace_back([this, index]{ Run(index); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::scoped_lock poolLock{ mutex_ };
+        shutdown_ = true;
+    }
+    workConditionVariable_.notify_all();
+
+    //Threads leave only once nothing is queued, so every task runs
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+void WorkStealingPool::Submit(Task task)
+{
+    {
+        std::scoped_lock poolLock{ mutex_ };
+        const auto index = currentPool == this ? currentWorker : nextWorker_++ % workers_.size();
+
+        //Pushed under the pool lock so the task cannot be counted off before it is counted on
+        {
+            std::scoped_lock workerLock{ workers_[index]->mutex_ };
+            workers_[index]->tasks_.push_back(std::move(task));
+        }
+        ++queued_;
+        ++unfinished_;
+    }
+    workConditionVariable_.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+    std::unique_lock poolLock{ mutex_ };
+    idleConditionVariable_.wait(poolLock, [this]{ return unfinished_ == 0; });
+}
+
+std::optional<WorkStealingPool::Task> WorkStealingPool::TryTake(std::size_t self)
+{
+    std::optional<Task> task;
+
+    for (std::size_t offset = 0; offset < workers_.size() && !task; ++offset)
+    {
+        auto& worker = *workers_[(self + offset) % workers_.size()];
+        std::scoped_lock workerLock{ worker.mutex_ };
+        if (worker.tasks_.empty())
+            continue;
+
+        if (offset == 0)
+        {
+            task = std::move(worker.tasks_.back());
+            worker.tasks_.pop_back();
+        }
+        else
+        {
+            task = std::move(worker.tasks_.front());
+            worker.tasks_.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (task)
+    {
+        std::scoped_lock poolLock{ mutex_ };
+        --queued_;
+    }
+    return task;
+}
+
+void WorkStealingPool::Run(std::size_t self)
+{
+    currentPool = this;
+    currentWorker = self;
+
+    while (true)
+    {
+        if (auto task = TryTake(self))
+        {
+            (*task)();
+
+            std::scoped_lock poolLock{ mutex_ };
+            if (--unfinished_ == 0)
+                idleConditionVariable_.notify_all();
+            continue;
+        }
+
+        std::unique_lock poolLock{ mutex_ };
+        workConditionVariable_.wait(poolLock, [this]{ return shutdown_ || queued_ > 0; });
+        if (shutdown_ && queued_ == 0)
+            return;
+    }
+}